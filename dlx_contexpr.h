@@ -6,10 +6,19 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <set>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace dlx {
     /** INPUT PARAMETERS **/
@@ -20,6 +29,466 @@ namespace dlx {
     template<size_t NumNodes>
     using position_array = std::array<position, NumNodes>;
 
+    /// Positions for problems whose size is only known at run time, or which are too large for the stack.
+    using position_vector = std::vector<position>;
+
+    /// The colours of the positions of a run-time problem, with 0 for a position without a colour.
+    using colour_vector = std::vector<size_t>;
+
+    /// A permutation of the rows of a problem, mapping row r to permutation[r].
+    using row_permutation = std::vector<index>;
+
+    namespace details {
+        /// The number of bits in a word of a column bitmap.
+        constexpr size_t WordBits = 64;
+
+        /**
+         * Verify that a set of rows is a solution, i.e. it covers each primary column exactly once and each
+         * secondary column at most once. The columns covered so far are kept in a bitmap, so a column covered twice
+         * is caught by a single test, and the primary columns that are covered are counted a word at a time.
+         *
+         * @param positions the positions describing the subsets
+         * @param numCols the number of columns
+         * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+         * @param sol the rows, indexed by row
+         * @param covered a zeroed bitmap with at least numCols bits, for the columns covered
+         * @return true if the rows form a solution, and false otherwise
+         */
+        template<typename Positions, typename Solution, typename Words>
+        constexpr bool verifyCover(const Positions &positions, [[maybe_unused]] size_t numCols, size_t numPrimaryCols,
+                                   const Solution &sol, Words &covered) noexcept {
+            for (const auto &[row, column]: positions) {
+                if (!sol[row]) continue;
+                assert(0 <= column && static_cast<size_t>(column) < numCols);
+
+                const std::uint64_t bit = std::uint64_t{1} << (column % WordBits);
+                auto &word = covered[column / WordBits];
+                if (word & bit)
+                    return false;
+                word |= bit;
+            }
+
+            // Count the primary columns covered, masking off the secondary columns in the last word.
+            size_t primary = 0;
+            for (size_t w = 0; w * WordBits < numPrimaryCols; ++w) {
+                const auto remaining = numPrimaryCols - w * WordBits;
+                const auto mask = remaining >= WordBits ? ~std::uint64_t{0} : (std::uint64_t{1} << remaining) - 1;
+                primary += __builtin_popcountll(covered[w] & mask);
+            }
+            return primary == numPrimaryCols;
+        }
+
+        /// A set of columns, as a bitmap.
+        using column_set = std::vector<std::uint64_t>;
+
+        /// A hash of a set of columns, for the memo tables of counting.
+        struct column_set_hash {
+            size_t operator()(const column_set &cs) const noexcept {
+                std::uint64_t h = 0xcbf29ce484222325ull;
+                for (const auto word: cs)
+                    h = (h ^ word) * 0x100000001b3ull;
+                return static_cast<size_t>(h);
+            }
+        };
+
+        /// The colours of a problem without colours, which take no storage.
+        struct no_colours {};
+
+        /**
+         * The dancing links of an exact cover problem and the search over them, shared by DLX, which keeps the
+         * links in arrays so that the search can run in a constant expression, and RuntimeDLX, which keeps them in
+         * vectors on the heap.
+         *
+         * The nodes are numbered as follows: the column headers come first, then the header of the list of
+         * columns, whose index is the number of columns, and then the nodes of the positions, in order. The primary
+         * columns are linked into the list of columns, and the secondary columns link only to themselves.
+         *
+         * If Colours is not no_colours, the nodes also carry colours, with 0 for none, and a chosen row purifies its
+         * coloured columns rather than covering them, as described in RuntimeDLX.
+         *
+         * @tparam Sizes the storage for the lengths of the columns, indexed by column
+         * @tparam Links the storage for the links, indexed by node
+         * @tparam Colours the storage for the colours, indexed by node, or no_colours
+         */
+        template<typename Sizes, typename Links, typename Colours = no_colours>
+        struct dancing_links {
+            static constexpr bool Coloured = !std::is_same_v<Colours, no_colours>;
+
+            // The colour of a node whose column has been purified to its colour by another row.
+            static constexpr size_t Purified = std::numeric_limits<size_t>::max();
+
+            // The header of the list of columns.
+            index header{};
+
+            // Header-specific: column length.
+            Sizes S{};
+
+            // For all nodes: directional indices, the column header, and the row.
+            Links R{};
+            Links L{};
+            Links U{};
+            Links D{};
+            Links C{};
+            Links RM{};
+
+            // For all nodes: the colour, which is 0 for none and Purified once the column has been purified to it.
+            Colours Colour{};
+
+            /**
+             * Link the nodes of the positions into the columns. The storage must already have room for numCols + 1
+             * column headers and the nodes of the positions.
+             *
+             * @param positions the positions describing the subsets, sorted by row
+             * @param numCols the number of columns
+             * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+             * @param numRows the number of rows, which is the row of the column headers
+             */
+            template<typename Positions>
+            constexpr void link(const Positions &positions, size_t numCols, size_t numPrimaryCols,
+                                size_t numRows) noexcept {
+                assert(numPrimaryCols <= numCols);
+                assert(S.size() == numCols + 1 && R.size() == numCols + 1 + positions.size());
+                header = numCols;
+                const size_t headerSize = numCols + 1;
+
+                // Create the header data.
+                for (index i = 0; i < headerSize; ++i) {
+                    U[i] = i;
+                    D[i] = i;
+                    C[i] = i;
+                    S[i] = 0;
+                    RM[i] = numRows;
+                }
+
+                // Do the L-R linking of the primary columns. The secondary columns link only to themselves.
+                for (index i = 0; i < numPrimaryCols; ++i) {
+                    R[i] = i + 1 < numPrimaryCols ? i + 1 : header;
+                    L[i] = i > 0 ? i - 1 : header;
+                }
+                for (index i = numPrimaryCols; i < numCols; ++i) {
+                    R[i] = i;
+                    L[i] = i;
+                }
+                R[header] = numPrimaryCols > 0 ? 0 : header;
+                L[header] = numPrimaryCols > 0 ? numPrimaryCols - 1 : header;
+
+                // Now handle the rows, each of which starts where the row number of the positions changes.
+                index rowStartIdx = 0;
+                for (index idx = 0; idx < positions.size(); ++idx) {
+                    const auto [row, column] = positions[idx];
+                    const index posIdx = headerSize + idx;
+                    if (idx > 0 && positions[idx - 1].first != row)
+                        rowStartIdx = idx;
+
+                    // Set the row and column for the new node.
+                    C[posIdx] = column;
+                    RM[posIdx] = row;
+
+                    // Link to bottom of column, with up pointing to col's previous up, and down to header.
+                    U[posIdx] = U[column];
+                    D[posIdx] = column;
+                    D[U[column]] = posIdx;
+                    U[column] = posIdx;
+                    ++S[column];
+
+                    // Link left to previous, if there is one, and right to first in row.
+                    L[posIdx] = idx > rowStartIdx ? posIdx - 1 : posIdx;
+                    R[posIdx] = rowStartIdx + headerSize;
+                    L[R[posIdx]] = posIdx;
+                    R[L[posIdx]] = posIdx;
+                }
+            }
+
+            /**
+             * Covers a column, i.e. removes the column from the header, and then removes all rows that have entries
+             * in the column from the problem. Nodes in purified columns stay where they are, as they no longer
+             * matter.
+             *
+             * Note that executing:
+             * 1. coverColumn(idx)
+             * 2. uncoverColumn(idx)
+             * should leave the problem unchanged.
+             *
+             * @param columnIdx the index of the column
+             */
+            constexpr void coverColumn(index columnIdx) noexcept {
+                assert(columnIdx < header);
+
+                // Remove the column from the header.
+                L[R[columnIdx]] = L[columnIdx];
+                R[L[columnIdx]] = R[columnIdx];
+
+                // Iterate over the rows covered by this column and remove them.
+                for (index i = D[columnIdx]; i != columnIdx; i = D[i])
+                    hideRow(i);
+            }
+
+            /**
+             * Uncovers a column, i.e. restores all rows that have entries in the column, and then restores the
+             * column to the header.
+             *
+             * @param columnIdx the index of the column
+             */
+            constexpr void uncoverColumn(index columnIdx) noexcept {
+                assert(columnIdx < header);
+
+                // Reverse the removal of the rows from coverColumn.
+                for (index i = U[columnIdx]; i != columnIdx; i = U[i])
+                    unhideRow(i);
+
+                // Restore the column to the header.
+                R[L[columnIdx]] = columnIdx;
+                L[R[columnIdx]] = columnIdx;
+            }
+
+            /// Remove the nodes of the row of a node, other than the node itself, from their columns.
+            constexpr void hideRow(index i) noexcept {
+                for (index j = R[i]; j != i; j = R[j]) {
+                    if constexpr (Coloured)
+                        if (Colour[j] == Purified)
+                            continue;
+                    U[D[j]] = U[j];
+                    D[U[j]] = D[j];
+                    --S[C[j]];
+                }
+            }
+
+            /// Undo hideRow.
+            constexpr void unhideRow(index i) noexcept {
+                for (index j = L[i]; j != i; j = L[j]) {
+                    if constexpr (Coloured)
+                        if (Colour[j] == Purified)
+                            continue;
+                    ++S[C[j]];
+                    D[U[j]] = j;
+                    U[D[j]] = j;
+                }
+            }
+
+            /**
+             * Purify the column of a coloured node: hide the rows giving the column other colours, and mark the
+             * nodes of the rows giving it the same colour, which may all still be chosen.
+             */
+            constexpr void purifyColumn(index p) noexcept {
+                const auto columnIdx = C[p];
+                for (index i = D[columnIdx]; i != columnIdx; i = D[i]) {
+                    if (Colour[i] != Colour[p])
+                        hideRow(i);
+                    else if (i != p)
+                        Colour[i] = Purified;
+                }
+            }
+
+            /// Undo purifyColumn.
+            constexpr void unpurifyColumn(index p) noexcept {
+                const auto columnIdx = C[p];
+                for (index i = U[columnIdx]; i != columnIdx; i = U[i]) {
+                    if (Colour[i] == Purified)
+                        Colour[i] = Colour[p];
+                    else if (Colour[i] != Colour[p])
+                        unhideRow(i);
+                }
+            }
+
+            /**
+             * Take the column of a node of a chosen row out of the problem: cover it if the node has no colour, and
+             * purify it if the node has a colour that has not already been imposed on the column.
+             */
+            constexpr void commitColumn(index j) noexcept {
+                if constexpr (Coloured) {
+                    if (Colour[j] == Purified)
+                        return;
+                    if (Colour[j] != 0) {
+                        purifyColumn(j);
+                        return;
+                    }
+                }
+                coverColumn(C[j]);
+            }
+
+            /// Undo commitColumn.
+            constexpr void uncommitColumn(index j) noexcept {
+                if constexpr (Coloured) {
+                    if (Colour[j] == Purified)
+                        return;
+                    if (Colour[j] != 0) {
+                        unpurifyColumn(j);
+                        return;
+                    }
+                }
+                uncoverColumn(C[j]);
+            }
+
+            /**
+             * Given a node index for a node in a row, include the row in the partial solution by taking all of
+             * the columns in the row out of the problem. It is the responsibility of the caller to mark the row in
+             * the solution.
+             *
+             * Note that executing:
+             * 1. useRow(idx)
+             * 2. unuseRow(idx)
+             * should leave the problem unchanged, and that calls must be nested, i.e. rows must be unused in the
+             * reverse order in which they were used.
+             *
+             * @param rowIdx the index of a node in the row
+             */
+            constexpr void useRow(index rowIdx) noexcept {
+                assert(rowIdx > header && rowIdx < R.size());
+
+                index i = rowIdx;
+                do {
+                    commitColumn(i);
+                    i = R[i];
+                } while (i != rowIdx);
+            }
+
+            /**
+             * Given a node index for a node in a row, remove the row from the partial solution by restoring all
+             * of the columns in the row in the reverse order in which useRow took them out.
+             *
+             * @param rowIdx the index of a node in the row
+             */
+            constexpr void unuseRow(index rowIdx) noexcept {
+                assert(rowIdx > header && rowIdx < R.size());
+
+                // Finish with the column of rowIdx, which was taken out first.
+                index i = rowIdx;
+                do {
+                    i = L[i];
+                    uncommitColumn(i);
+                } while (i != rowIdx);
+            }
+
+            /**
+             * Given a node index for a node in a row, unlink the row from all of its columns so that the search
+             * can never select it. The row remains linked left and right, so it can be restored with includeRow.
+             *
+             * @param rowIdx the index of a node in the row
+             */
+            constexpr void excludeRow(index rowIdx) noexcept {
+                assert(rowIdx > header && rowIdx < R.size());
+
+                index j = rowIdx;
+                do {
+                    U[D[j]] = U[j];
+                    D[U[j]] = D[j];
+                    --S[C[j]];
+                    j = R[j];
+                } while (j != rowIdx);
+            }
+
+            /// Reverse the operation of excludeRow.
+            constexpr void includeRow(index rowIdx) noexcept {
+                assert(rowIdx > header && rowIdx < R.size());
+
+                index j = rowIdx;
+                do {
+                    j = L[j];
+                    ++S[C[j]];
+                    D[U[j]] = j;
+                    U[D[j]] = j;
+                } while (j != rowIdx);
+            }
+
+            /**
+             * Choose the column with the fewest rows to minimize the branching factor. The scan stops at a column
+             * with at most one row, as none can have fewer that matter: a column with one row is a forced move,
+             * and one with no rows is a dead end.
+             *
+             * @return the column, or the header if all primary columns are covered
+             */
+            constexpr index chooseColumn() const noexcept {
+                index minColumnIndex = R[header];
+                for (index i = R[minColumnIndex]; i != header && S[minColumnIndex] > 1; i = R[i])
+                    if (S[i] < S[minColumnIndex])
+                        minColumnIndex = i;
+                return minColumnIndex;
+            }
+
+            /**
+             * Attempt to locate a solution to the exact cover problem using backtracking on the rows. The general
+             * strategy is:
+             * 1. If all columns are covered, solution found.
+             * 2. Otherwise pick the column with the least rows (to minimize branching factor).
+             * 3. Recurse over all possibilities of adding the rows covering thhe column to the answer.
+             *
+             * The algorithm manipulates the links between rows and columns as per Knuth's DLX paper to efficiently
+             * expand / backtrack. The links are left unchanged, even if a solution is found.
+             *
+             * @param sol the rows chosen so far, indexed by row, to which the rows of the solution are added
+             * @return true if a solution was found, in which case it is in sol, and false otherwise
+             */
+            template<typename Solution>
+            constexpr bool find_solution(Solution &sol) noexcept {
+                // Check to see if we have a complete solution, i.e if the header only loops to itself.
+                if (R[header] == header)
+                    return true;
+
+                // If there are no available rows to cover the column, we cannot extend.
+                const index minColumnIndex = chooseColumn();
+                if (S[minColumnIndex] == 0)
+                    return false;
+
+                coverColumn(minColumnIndex);
+
+                // Now extend the solution by trying each possible row in the column.
+                bool found = false;
+                for (index i = D[minColumnIndex]; i != minColumnIndex && !found; i = D[i]) {
+                    sol[RM[i]] = true;
+                    for (index j = R[i]; j != i; j = R[j])
+                        commitColumn(j);
+
+                    found = find_solution(sol);
+                    if (!found)
+                        sol[RM[i]] = false;
+
+                    // Reverse the operation. We do this even if we found a solution so that the state is left
+                    // unchanged for the caller.
+                    for (index j = L[i]; j != i; j = L[j])
+                        uncommitColumn(j);
+                }
+
+                uncoverColumn(minColumnIndex);
+                return found;
+            }
+
+            /**
+             * Count the solutions reachable from the current state, stopping as soon as limit solutions have been
+             * found. Like find_solution, this leaves the state exactly as it found it, so it can be called
+             * repeatedly on a state that is being modified incrementally.
+             *
+             * A limit of 2 is the classic uniqueness check: the search stops at the second solution.
+             *
+             * @param limit the number of solutions after which to stop searching
+             * @return the number of solutions found, which is at most limit
+             */
+            constexpr size_t count_solutions(size_t limit) noexcept {
+                if (R[header] == header)
+                    return 1;
+
+                const index minColumnIndex = chooseColumn();
+                if (S[minColumnIndex] == 0)
+                    return 0;
+
+                coverColumn(minColumnIndex);
+
+                size_t count = 0;
+                for (index i = D[minColumnIndex]; i != minColumnIndex && count < limit; i = D[i]) {
+                    for (index j = R[i]; j != i; j = R[j])
+                        commitColumn(j);
+
+                    count += count_solutions(limit - count);
+
+                    for (index j = L[i]; j != i; j = L[j])
+                        uncommitColumn(j);
+                }
+
+                uncoverColumn(minColumnIndex);
+                return count;
+            }
+        };
+    }
+
     /**
      * We represent an instance of the dancing links algorithm (an exact cover problem) which comprises:
      * 1. A header, representing the elements of the set to cover.
@@ -30,19 +499,26 @@ namespace dlx {
      * Note that the algorithm can be run entirely at compile time (but need not be),and only the first solution
      * found is returned. It would be ideal if we could return all solutions found, but I cannot ascertain a way to
      * do so in a constexpr setting. (We could, for example, allocate enough room for, say, 100 solutions and see
-     * how many the algorithm finds.)
+     * how many the algorithm finds.) Solutions can, however, be counted, optionally up to a limit, which is
+     * enough to check uniqueness.
      *
      * Note that DLX is uninstantiable and thus just a class of static methods. They could be separated, but we keep
      * them so categorized so that the template sizes carry around, and also to enforce encapsulation, as there
      * are certain methods the user should not call.
      *
+     * The first NumPrimaryCols columns are primary, i.e. they must be covered exactly once, and the remaining
+     * columns are secondary, i.e. they must be covered at most once. As per Knuth, secondary columns are simply
+     * never linked into the header, so the search never chooses them, but covering a row still removes the
+     * rows that conflict with it in a secondary column.
+     *
      * There are a number of improvements that could be made: these will be documented as issues in github.
      * 
      * @tparam NumCols the number of elements in the set to cover
      * @tparam NumRows the number of rows n the array of nodes
      * @tparam NumNodes the size of the array of nodes
+     * @tparam NumPrimaryCols the number of primary columns, which come before the secondary columns
      */
-    template<size_t NumCols, size_t NumRows, size_t NumNodes>
+    template<size_t NumCols, size_t NumRows, size_t NumNodes, size_t NumPrimaryCols = NumCols>
     class DLX final {
     public:
         /** OUTPUT **/
@@ -51,332 +527,1408 @@ namespace dlx {
     private:
         /** INTERNAL DATA TYPES **/
         static constexpr size_t dim = NumCols + 1 + NumNodes;
-        using direction = std::array<index, dim>;
 
-        // The index of the header, the size of the header, the length of a column, and the type of column, which
-        // determines if columns are primary (must be covered once) or secondary (covered at most once).
+        // The index of the header and the size of the header. The first NumPrimaryCols columns are primary (must
+        // be covered once), and the rest are secondary (covered at most once).
         static constexpr index header = NumCols;
         static constexpr size_t HeaderSize = NumCols + 1;
-        using column_length = std::array<size_t, HeaderSize>;
+        static_assert(NumPrimaryCols <= NumCols, "There cannot be more primary columns than columns");
 
-        // A mapping from nodes to rows.
-        // The header counts as the NumRows-th row.
-        using row_mapping = std::array<index, dim>;
+        /**
+         * The internal state used to model the problem, in arrays, so that it can be used in a constant expression.
+         * The header counts as the NumRows-th row.
+         */
+        using data = details::dancing_links<std::array<size_t, HeaderSize>, std::array<index, dim>>;
 
         /**
-         * The internal state used to model the problem.
+         * Initialize the problem by taking the array of positions and populating the DLX array.
+         * These define the rows that comprise the subets for the exact cover.
+         *
+         * @param positions the positions that describe the subsets
+         * @return data object representing the DLX problem
          */
-        struct data {
-            // Header-specific: column type and length.
-            column_length S{};
+        static constexpr data init(const position_array<NumNodes> &positions) noexcept {
+            data d{};
+            d.link(positions, NumCols, NumPrimaryCols, NumRows);
+            return d;
+        }
 
-            // For all nodes: directional indices, including the column header.
-            direction R{}; // right
-            direction L{}; // left
-            direction U{}; // up
-            direction D{}; // down
-            direction C{}; // column header
+        /**
+         * Create the solution and initialize it.
+         * @return empty solution array
+         */
+        static constexpr solution init_solution() noexcept {
+            solution sol{};
+            for (auto &s: sol)
+                s = false;
+            return sol;
+        }
 
-            // The coordinates of rows.
-            row_mapping RM{};
-        };
+        /**
+         * Search for a solution extending the rows already marked in sol.
+         *
+         * @param state the DLX state, which is left unchanged
+         * @param sol the rows chosen so far
+         * @return the solution if one exists, and nullopt if not
+         */
+        static constexpr std::optional<solution> find_solution(data &state, solution sol) noexcept {
+            if (state.find_solution(sol))
+                return sol;
+            return std::nullopt;
+        }
+
+    public:
+        DLX() = delete;
+
+        /**
+         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r, run the
+         * exact cover problem using Knuth's dancing links algorithm.
+         *
+         * @param positions list of the positions describing the subsets
+         * @return the first solution found if one exists, or nullopt otherwise
+         */
+        static constexpr std::optional<solution> run(const position_array<NumNodes> &positions) noexcept {
+            auto state = init(positions);
+            return find_solution(state, init_solution());
+        }
+
+        /**
+         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r,
+         * and a set of rows to force into the final solution, run the  exact cover problem using Knuth's
+         * dancing links algorithm.
+         *
+         * @param positions list of the positions describing the subsets
+         * @param fixed_rows a list of fixed rows (not offset by the header)
+         * @return the first solution found if one exists, or nullopt otherwise
+         */
+        template<size_t NumFixedRows>
+        static constexpr std::optional<solution> run(const position_array<NumNodes> &positions,
+                const std::array<size_t, NumFixedRows> &fixed_rows) noexcept {
+            auto state = init(positions);
+
+            // Initialize the solution.
+            auto sol = init_solution();
+
+            for (const auto row: fixed_rows) {
+                sol[state.RM[row + HeaderSize]] = true;
+                state.useRow(row + HeaderSize);
+            }
+            return find_solution(state, sol);
+        }
+
+        /**
+         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r, count the
+         * number of exact covers, stopping once limit of them have been found.
+         *
+         * @param positions list of the positions describing the subsets
+         * @param limit the number of solutions after which to stop searching
+         * @return the number of solutions, capped at limit
+         */
+        static constexpr size_t count(const position_array<NumNodes> &positions,
+                size_t limit = std::numeric_limits<size_t>::max()) noexcept {
+            auto state = init(positions);
+            return state.count_solutions(limit);
+        }
 
         /**
-         * Covers a column, i.e. removes the column from the header, and then removes all rows that have entries
-         * in the column from the problem.
+         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r,
+         * and a set of rows to force into the final solution, count the number of exact covers, stopping
+         * once limit of them have been found.
          *
-         * Note that executing:
-         * 1. coverColumn(state, idx)
-         * 2. uncoverColumn(state, idx)
-         * should leave the problem unchanged.
+         * @param positions list of the positions describing the subsets
+         * @param fixed_rows a list of fixed rows (not offset by the header)
+         * @param limit the number of solutions after which to stop searching
+         * @return the number of solutions, capped at limit
+         */
+        template<size_t NumFixedRows>
+        static constexpr size_t count(const position_array<NumNodes> &positions,
+                const std::array<size_t, NumFixedRows> &fixed_rows,
+                size_t limit = std::numeric_limits<size_t>::max()) noexcept {
+            auto state = init(positions);
+            for (const auto row: fixed_rows)
+                state.useRow(row + HeaderSize);
+            return state.count_solutions(limit);
+        }
+
+        /**
+         * Verify that a set of rows is a solution of the problem given by the positions, i.e. that it covers every
+         * primary column exactly once and every secondary column at most once.
          *
-         * @param state the DLX state
-         * @param columnIdx the index of the column
+         * @param positions list of the positions describing the subsets
+         * @param sol the rows to verify, e.g. as returned by run
+         * @return true if sol is a solution, and false otherwise
+         */
+        static constexpr bool verify(const position_array<NumNodes> &positions, const solution &sol) noexcept {
+            std::array<std::uint64_t, (NumCols + details::WordBits - 1) / details::WordBits> covered{};
+            return details::verifyCover(positions, NumCols, NumPrimaryCols, sol, covered);
+        }
+
+        /** INCREMENTAL INTERFACE **/
+
+        /**
+         * The search state, exposed so that callers that solve many closely related problems (for example, the
+         * same Sudoku with one clue more or less) can modify a single state incrementally instead of rebuilding
+         * it from the positions every time. The state may only be manipulated through the methods below.
          */
-        template <typename Data>
-        static constexpr void coverColumn(Data &&state, index columnIdx) noexcept {
-            assert(0 <= columnIdx && columnIdx < header);
+        using state = data;
 
-            // Remove the column from the header.
-            state.L[state.R[columnIdx]] = state.L[columnIdx];
-            state.R[state.L[columnIdx]] = state.R[columnIdx];
+        /**
+         * Build the initial state for the given positions.
+         *
+         * @param positions list of the positions describing the subsets
+         * @return the state with no rows forced or excluded
+         */
+        static constexpr state make_state(const position_array<NumNodes> &positions) noexcept {
+            return init(positions);
+        }
+
+        /**
+         * Force a row into every solution of the state. Rows must be released in the reverse order in which
+         * they were forced, and must not conflict with any row that is already forced.
+         *
+         * @param st the state
+         * @param row a node index in the row (not offset by the header), as passed to run
+         */
+        static constexpr void force_row(state &st, index row) noexcept {
+            st.useRow(row + HeaderSize);
+        }
+
+        /**
+         * Undo a force_row.
+         *
+         * @param st the state
+         * @param row a node index in the row (not offset by the header), as passed to force_row
+         */
+        static constexpr void release_row(state &st, index row) noexcept {
+            st.unuseRow(row + HeaderSize);
+        }
+
+        /**
+         * Forbid a row from appearing in any solution of the state. The row must not be covered by a forced
+         * row at the time of the call, and exclusions nest with force_row in the same way as releases do.
+         *
+         * @param st the state
+         * @param row a node index in the row (not offset by the header)
+         */
+        static constexpr void exclude_row(state &st, index row) noexcept {
+            st.excludeRow(row + HeaderSize);
+        }
+
+        /**
+         * Undo an exclude_row.
+         *
+         * @param st the state
+         * @param row a node index in the row (not offset by the header), as passed to exclude_row
+         */
+        static constexpr void include_row(state &st, index row) noexcept {
+            st.includeRow(row + HeaderSize);
+        }
+
+        /**
+         * Find a solution of the state. The state is left unchanged.
+         *
+         * @param st the state
+         * @return the first solution found if one exists, or nullopt otherwise; note that only the rows chosen
+         *         by the search are marked, and not those forced by force_row
+         */
+        static constexpr std::optional<solution> find(state &st) noexcept {
+            return find_solution(st, init_solution());
+        }
+
+        /**
+         * Count the solutions of the state, stopping once limit of them have been found. The state is left
+         * unchanged.
+         *
+         * @param st the state
+         * @param limit the number of solutions after which to stop searching
+         * @return the number of solutions, capped at limit
+         */
+        static constexpr size_t count(state &st, size_t limit = std::numeric_limits<size_t>::max()) noexcept {
+            return st.count_solutions(limit);
+        }
+    };
+
+    /**
+     * A vertex-coloured undirected graph, as adjacency lists, for canonical_labeling. Exact cover problems are
+     * compared through their row-column incidence graphs, with the rows and columns coloured differently.
+     */
+    struct coloured_graph {
+        std::vector<std::vector<index>> adjacency;
+        std::vector<size_t> colours;
+    };
+
+    /**
+     * The result of canonical_labeling: the canonical label of each vertex, and generators of the automorphism
+     * group of the graph as permutations of its vertices.
+     */
+    struct labeling {
+        std::vector<index> labels;
+        std::vector<std::vector<index>> automorphisms;
+    };
+
+    namespace details {
+        /**
+         * An individualization-refinement search for the canonical labeling of a coloured_graph. The partition of
+         * the vertices is held as an ordering of the vertices in which every cell is a contiguous range, with the
+         * start of the cell of each vertex and the end of each cell indexed by its start.
+         *
+         * Every node of the search refines its partition to an equitable one, and the children individualize each
+         * vertex of the first non-singleton cell in turn. The canonical labeling is the leaf that is smallest in
+         * the order of the refinement traces along its path and then of the relabeled graph, so subtrees whose
+         * trace exceeds that of the best leaf are pruned, as are children in the same orbit as an earlier child
+         * under the automorphisms found so far that fix the path.
+         */
+        class canonical_search final {
+        public:
+            explicit canonical_search(const coloured_graph &g): g{g}, n{g.adjacency.size()} {}
+
+            labeling run() {
+                partition p{std::vector<index>(n), std::vector<index>(n), std::vector<index>(n + 1)};
+                for (index v = 0; v < n; ++v)
+                    p.order[v] = v;
+                std::stable_sort(p.order.begin(), p.order.end(),
+                                 [this](index u, index w) { return g.colours[u] < g.colours[w]; });
+
+                // Make the colour classes the initial cells, all of which are splitters.
+                std::vector<index> splitters;
+                for (index i = 0; i < n; ++i) {
+                    if (i == 0 || g.colours[p.order[i]] != g.colours[p.order[i - 1]]) {
+                        splitters.emplace_back(i);
+                        index e = i + 1;
+                        while (e < n && g.colours[p.order[e]] == g.colours[p.order[i]])
+                            ++e;
+                        p.cellEnd[i] = e;
+                    }
+                    p.cellOf[p.order[i]] = splitters.back();
+                }
+
+                std::vector<index> path;
+                std::vector<std::vector<size_t>> traces;
+                search(p, splitters, path, traces);
+
+                labeling result{std::vector<index>(n), std::move(automorphisms)};
+                for (index i = 0; i < n; ++i)
+                    result.labels[bestOrder[i]] = i;
+                return result;
+            }
+
+        private:
+            struct partition {
+                std::vector<index> order;
+                std::vector<index> cellOf;
+                std::vector<index> cellEnd;
+            };
+
+            const coloured_graph &g;
+            size_t n;
+
+            // The best leaf so far: its traces, certificate, and ordering, and the first leaf, for automorphisms.
+            bool haveBest = false;
+            std::vector<std::vector<size_t>> bestTraces;
+            std::vector<size_t> bestCertificate;
+            std::vector<index> bestOrder;
+            std::vector<size_t> firstCertificate;
+            std::vector<index> firstOrder;
+            std::vector<std::vector<index>> automorphisms;
+
+            /**
+             * Refine the partition until it is equitable, i.e. every vertex of a cell has the same number of
+             * neighbours in every cell, recording the sizes of the fragments and their neighbour counts in trace.
+             */
+            void refine(partition &p, std::vector<index> splitters, std::vector<size_t> &trace) const {
+                std::vector<size_t> count(n);
+                while (!splitters.empty()) {
+                    const auto s = splitters.back();
+                    splitters.pop_back();
+
+                    std::fill(count.begin(), count.end(), 0);
+                    for (index i = s; i < p.cellEnd[s]; ++i)
+                        for (const auto w: g.adjacency[p.order[i]])
+                            ++count[w];
+
+                    for (index c = 0; c < n; c = p.cellEnd[c]) {
+                        const auto e = p.cellEnd[c];
+                        if (e - c == 1) continue;
+
+                        const auto first = p.order.begin() + c;
+                        const auto last = p.order.begin() + e;
+                        std::stable_sort(first, last, [&count](index u, index w) { return count[u] < count[w]; });
+                        if (count[p.order[c]] == count[p.order[e - 1]]) continue;
+
+                        // Split the cell into fragments of equal counts, all of which become splitters.
+                        trace.emplace_back(c);
+                        for (index i = c; i < e;) {
+                            index j = i + 1;
+                            while (j < e && count[p.order[j]] == count[p.order[i]])
+                                ++j;
+                            for (index k = i; k < j; ++k)
+                                p.cellOf[p.order[k]] = i;
+                            p.cellEnd[i] = j;
+                            trace.emplace_back(j - i);
+                            trace.emplace_back(count[p.order[i]]);
+                            splitters.emplace_back(i);
+                            i = j;
+                        }
+                    }
+                }
+            }
+
+            /// The relabeled graph of a discrete partition: the colour, degree, and sorted neighbours of each label.
+            std::vector<size_t> certificate(const partition &p) const {
+                std::vector<size_t> cert;
+                std::vector<size_t> neighbours;
+                for (index i = 0; i < n; ++i) {
+                    const auto v = p.order[i];
+                    neighbours.clear();
+                    for (const auto w: g.adjacency[v])
+                        neighbours.emplace_back(p.cellOf[w]);
+                    std::sort(neighbours.begin(), neighbours.end());
+                    cert.emplace_back(g.colours[v]);
+                    cert.emplace_back(neighbours.size());
+                    cert.insert(cert.end(), neighbours.cbegin(), neighbours.cend());
+                }
+                return cert;
+            }
 
-            // Iterate over the rows covered by this column and remove them.
-            for (index i = state.D[columnIdx]; i != columnIdx; i = state.D[i]) {
-                // Remove row i from the problem.
-                for (index j = state.R[i]; j != i; j = state.R[j]) {
-                    state.U[state.D[j]] = state.U[j];
-                    state.D[state.U[j]] = state.D[j];
-                    --state.S[state.C[j]];
+            /// Record the automorphism mapping the vertices of order to those of target with the same labels.
+            void addAutomorphism(const std::vector<index> &order, const std::vector<index> &target) {
+                std::vector<index> gamma(n);
+                bool identity = true;
+                for (index i = 0; i < n; ++i) {
+                    gamma[order[i]] = target[i];
+                    identity = identity && order[i] == target[i];
                 }
+                if (!identity)
+                    automorphisms.emplace_back(std::move(gamma));
             }
+
+            /// Determine if u and w are in the same orbit of the automorphisms that fix the path pointwise.
+            bool sameOrbit(const std::vector<index> &path, index u, index w) const {
+                std::vector<index> parent(n);
+                for (index v = 0; v < n; ++v)
+                    parent[v] = v;
+                const auto find = [&parent](index v) {
+                    while (parent[v] != v)
+                        v = parent[v] = parent[parent[v]];
+                    return v;
+                };
+
+                for (const auto &gamma: automorphisms) {
+                    if (!std::all_of(path.cbegin(), path.cend(), [&gamma](index v) { return gamma[v] == v; }))
+                        continue;
+                    for (index v = 0; v < n; ++v)
+                        parent[find(v)] = find(gamma[v]);
+                }
+                return find(u) == find(w);
+            }
+
+            void search(partition &p, const std::vector<index> &splitters, std::vector<index> &path,
+                        std::vector<std::vector<size_t>> &traces) {
+                // Refine, and abandon the node if its trace is worse than that of the best leaf.
+                traces.emplace_back();
+                refine(p, splitters, traces.back());
+                const auto level = traces.size() - 1;
+                if (haveBest && level < bestTraces.size() &&
+                    std::lexicographical_compare(bestTraces.cbegin(), bestTraces.cbegin() + level + 1,
+                                                 traces.cbegin(), traces.cend())) {
+                    traces.pop_back();
+                    return;
+                }
+
+                // Find the first non-singleton cell, if any.
+                index target = 0;
+                while (target < n && p.cellEnd[target] - target == 1)
+                    target = p.cellEnd[target];
+
+                if (target == n) {
+                    // A leaf: compare its certificate to the first and best leaves.
+                    const auto cert = certificate(p);
+                    if (firstOrder.empty()) {
+                        firstCertificate = cert;
+                        firstOrder = p.order;
+                    } else if (cert == firstCertificate) {
+                        addAutomorphism(p.order, firstOrder);
+                    }
+
+                    const bool better = !haveBest || traces < bestTraces ||
+                                        (traces == bestTraces && cert < bestCertificate);
+                    if (haveBest && traces == bestTraces && cert == bestCertificate) {
+                        addAutomorphism(p.order, bestOrder);
+                    } else if (better) {
+                        haveBest = true;
+                        bestTraces = traces;
+                        bestCertificate = cert;
+                        bestOrder = p.order;
+                    }
+                    traces.pop_back();
+                    return;
+                }
+
+                std::vector<index> cell{p.order.begin() + target, p.order.begin() + p.cellEnd[target]};
+                std::sort(cell.begin(), cell.end());
+                std::vector<index> tried;
+                for (const auto v: cell) {
+                    if (std::any_of(tried.cbegin(), tried.cend(),
+                                    [&](index u) { return sameOrbit(path, u, v); }))
+                        continue;
+                    tried.emplace_back(v);
+
+                    // Individualize v by moving it to the front of its cell.
+                    auto child = p;
+                    const auto pos = std::find(child.order.begin() + target, child.order.end(), v);
+                    std::iter_swap(child.order.begin() + target, pos);
+                    const auto end = child.cellEnd[target];
+                    child.cellEnd[target] = target + 1;
+                    child.cellEnd[target + 1] = end;
+                    for (index i = target + 1; i < end; ++i)
+                        child.cellOf[child.order[i]] = target + 1;
+
+                    path.emplace_back(v);
+                    search(child, {target}, path, traces);
+                    path.pop_back();
+                }
+                traces.pop_back();
+            }
+        };
+    }
+
+    /**
+     * Find a canonical labeling of a vertex-coloured graph, i.e. a labeling such that two graphs are isomorphic
+     * by a colour-preserving isomorphism if and only if relabeling them gives the same graph. Colours keep their
+     * order: the vertices of the smallest colour receive the smallest labels. The automorphism generators that
+     * are found along the way are returned as well.
+     *
+     * @param g the graph
+     * @return the canonical labels of the vertices, and automorphism generators of g
+     */
+    inline labeling canonical_labeling(const coloured_graph &g) {
+        return details::canonical_search{g}.run();
+    }
+
+    /**
+     * A run-time counterpart of DLX for problems whose size is only known at run time, or which are too large to
+     * keep their state on the stack (e.g. 25x25 Sudoku boards). The links and the search are those of DLX, kept in
+     * vectors rather than arrays, and so are the conventions: positions are (row, column) pairs sorted by row, the
+     * first numPrimaryCols columns are primary and the rest secondary, and rows are identified by the index of any
+     * of their nodes in the positions.
+     *
+     * Unlike DLX, this class is instantiable: an instance holds the state of one problem on the heap, along with
+     * the rows that have been forced into it. Copying an instance is much cheaper than rebuilding it, so a single
+     * instance can be built once and then copied for each query or thread.
+     *
+     * The positions in secondary columns may also be given colours, which makes this an exact cover with colours
+     * (XCC) problem: a secondary column may then be covered by any number of rows, provided they all give it the
+     * same colour. A position without a colour still covers its column exclusively. When a row is chosen, each of
+     * its coloured columns is purified rather than covered: the rows giving it other colours are hidden, and those
+     * giving it the same colour are marked, so that choosing them later leaves the column alone.
+     */
+    class RuntimeDLX final: private details::dancing_links<std::vector<size_t>, std::vector<index>,
+                                                           colour_vector> {
+    public:
+        /** OUTPUT **/
+        using solution = std::vector<bool>;
+
+        /**
+         * Build the state for an exact cover problem.
+         *
+         * @param numCols the number of columns
+         * @param numRows the number of rows
+         * @param positions the positions describing the subsets, sorted by row
+         * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+         * @param colours the colours of the positions, which may only be nonzero in secondary columns, or empty
+         *                if there are none
+         */
+        RuntimeDLX(size_t numCols, size_t numRows, const position_vector &positions, size_t numPrimaryCols,
+                   const colour_vector &colours = {}):
+                numCols{numCols}, numRows{numRows}, HeaderSize{numCols + 1} {
+            assert(colours.empty() || colours.size() == positions.size());
+
+            // Make room for the header and the nodes, and link them as DLX does.
+            S.resize(HeaderSize);
+            for (auto *links: {&R, &L, &U, &D, &C, &RM})
+                links->resize(HeaderSize + positions.size());
+            Colour.assign(R.size(), 0);
+            link(positions, numCols, numPrimaryCols, numRows);
+
+            for (index idx = 0; idx < colours.size(); ++idx)
+                if (colours[idx]) {
+                    assert(static_cast<size_t>(positions[idx].second) >= numPrimaryCols);
+                    Colour[HeaderSize + idx] = colours[idx];
+                    hasColours = true;
+                }
+        }
+
+        /**
+         * Build the state for an exact cover problem in which all columns are primary.
+         *
+         * @param numCols the number of columns
+         * @param numRows the number of rows
+         * @param positions the positions describing the subsets, sorted by row
+         */
+        RuntimeDLX(size_t numCols, size_t numRows, const position_vector &positions):
+                RuntimeDLX{numCols, numRows, positions, numCols} {}
+
+        /// The number of columns.
+        size_t columns() const noexcept { return numCols; }
+
+        /// The number of rows.
+        size_t rows() const noexcept { return numRows; }
+
+        /**
+         * Force a row into every solution. Rows must be released in the reverse order in which they were forced,
+         * and must not conflict with any row that is already forced.
+         *
+         * @param row a node index in the row (not offset by the header)
+         */
+        void force_row(index row) noexcept {
+            useRow(row + HeaderSize);
+            forced.emplace_back(row + HeaderSize);
+        }
+
+        /**
+         * Undo the most recent force_row.
+         *
+         * @param row a node index in the row (not offset by the header), as passed to force_row
+         */
+        void release_row(index row) noexcept {
+            assert(!forced.empty() && forced.back() == row + HeaderSize);
+            forced.pop_back();
+            unuseRow(row + HeaderSize);
+        }
+
+        /**
+         * Forbid a row from appearing in any solution. The row must not be covered by a forced row at the time
+         * of the call, and exclusions nest with force_row in the same way as releases do.
+         *
+         * @param row a node index in the row (not offset by the header)
+         */
+        void exclude_row(index row) noexcept {
+            excludeRow(row + HeaderSize);
+        }
+
+        /**
+         * Undo an exclude_row.
+         *
+         * @param row a node index in the row (not offset by the header), as passed to exclude_row
+         */
+        void include_row(index row) noexcept {
+            includeRow(row + HeaderSize);
         }
 
         /**
-         * Uncovers a column, i.e. restores all rows that have entries in the column, and then restores the column
-         * to the header.
+         * Declare a group of symmetries of the problem, given by generators that permute the rows, e.g. the
+         * rotations of a board acting on the placements of pieces. Every element of the group must map solutions
+         * to solutions, and must fix the set of forced rows.
          *
-         * Note that executing:
-         * 1. coverColumn(state, idx)
-         * 2. uncoverColumn(state, idx)
-         * should leave the problem unchanged.
+         * From then on, run and count skip the rows of a column that some element of the group maps to a row of
+         * the column already tried, among the elements that fix the rows chosen so far. Such rows have the same
+         * completions up to symmetry, so run returns the first solution that survives, and count weights each row
+         * it does try by the number of rows it stands for, so that the count is still the number of solutions.
          *
-         * @param state the DLX state
-         * @param columnIdx the index of the column
+         * The whole group is generated and tested at every node of the search, so this is meant for small groups.
+         *
+         * @param generators the generators of the group, as permutations of the rows
          */
-        template <typename Data>
-        static constexpr void uncoverColumn(Data &&state, index columnIdx) noexcept {
-            assert(0 <= columnIdx && columnIdx < header);
+        void set_row_symmetries(const std::vector<row_permutation> &generators) {
+            group.clear();
+            if (generators.empty())
+                return;
 
-            // Reverse the removal of the rows from coverColumn.
-            for (index i = state.U[columnIdx]; i != columnIdx; i = state.U[i]) {
-                // Restore row i to the problem.
-                for (index j = state.L[i]; j != i; j = state.L[j]) {
-                    ++state.S[state.C[j]];
-                    state.D[state.U[j]] = j;
-                    state.U[state.D[j]] = j;
+            // Close the generators under composition.
+            row_permutation identity(numRows);
+            for (index r = 0; r < numRows; ++r)
+                identity[r] = r;
+            std::set<row_permutation> elements{identity};
+            std::vector<row_permutation> queue{identity};
+            while (!queue.empty()) {
+                const auto g = std::move(queue.back());
+                queue.pop_back();
+                for (const auto &gen: generators) {
+                    assert(gen.size() == numRows);
+                    row_permutation h(numRows);
+                    for (index r = 0; r < numRows; ++r)
+                        h[r] = gen[g[r]];
+                    if (elements.insert(h).second)
+                        queue.emplace_back(std::move(h));
                 }
             }
 
-            // Restore the column to the header.
-            state.R[state.L[columnIdx]] = columnIdx;
-            state.L[state.R[columnIdx]] = columnIdx;
+            // The identity never prunes anything.
+            elements.erase(identity);
+            group.assign(elements.cbegin(), elements.cend());
         }
 
         /**
-         * Given a node index for a node in a row, include the row in the partial solution.
+         * Find a solution, leaving the state unchanged.
          *
-         * Note that executing:
-         * 1. useRow(state, idx, sol)
-         * 2. unuseRow(state, idx, sol)
-         * should leave the problem unchhanged.
+         * @return the first solution found, including the forced rows, if one exists, or nullopt otherwise
+         */
+        std::optional<solution> run() {
+            solution sol(numRows, false);
+            std::vector<index> chosen;
+            for (const auto rowIdx: forced) {
+                sol[RM[rowIdx]] = true;
+                chosen.emplace_back(RM[rowIdx]);
+            }
+            if (group.empty() ? find_solution(sol) : findWithGroup(sol, chosen))
+                return sol;
+            return std::nullopt;
+        }
+
+        /**
+         * Count the solutions, stopping once limit of them have been found. The state is left unchanged.
+         *
+         * @param limit the number of solutions after which to stop searching
+         * @return the number of solutions, capped at limit
+         */
+        size_t count(size_t limit = std::numeric_limits<size_t>::max()) {
+            if (group.empty())
+                return count_solutions(limit);
+
+            solution sol(numRows, false);
+            std::vector<index> chosen;
+            for (const auto rowIdx: forced) {
+                sol[RM[rowIdx]] = true;
+                chosen.emplace_back(RM[rowIdx]);
+            }
+            return std::min(limit, countWithGroup(sol, chosen, limit));
+        }
+
+        /**
+         * Call callback with every solution, including the forced rows, leaving the state unchanged. The solution
+         * passed to callback is only valid for the duration of the call.
+         *
+         * @param callback the function to call with each solution
+         * @return the number of solutions
+         */
+        template<typename Callback>
+        size_t for_each_solution(Callback &&callback) {
+            solution sol(numRows, false);
+            for (const auto rowIdx: forced)
+                sol[RM[rowIdx]] = true;
+            return enumerate_solutions(sol, callback);
+        }
+
+        /**
+         * Count the solutions, using the symmetries of the problem to avoid exploring equivalent subtrees in the
+         * top levels of the search. At each of these levels, the automorphisms of the incidence graph of the
+         * remaining rows and columns that fix the chosen column are found with canonical_labeling. Rows of the
+         * column in the same orbit have the same number of completions, so only one row per orbit is searched,
+         * and its count is weighted by the size of the orbit. Below the top levels, the search proceeds as count.
+         * The state is left unchanged.
          *
-         * This method could be used to force certain rows into the solution.
-         * This would be a simple modification to make.
+         * This pays off for symmetric problems, which are most combinatorial ones, at the cost of a canonical
+         * labeling at every node of the top levels.
          *
-         * @param d the DLX state
-         * @param rowIdx the index of a node in the row
-         * @param sol the solution
+         * The automorphisms do not take colours into account, so for problems with colours, this counts as count
+         * does without a symmetry group.
+         *
+         * @param levels the number of levels at which to prune by symmetry
+         * @return the number of solutions
          */
-        template <typename Data, typename Solution>
-        static constexpr void useRow(Data &&state, index rowIdx, Solution &&sol) noexcept {
-            assert(rowIdx > header && rowIdx < HeaderSize + NumNodes);
-            sol[state.RM[rowIdx]] = true;
+        size_t count_with_symmetry(size_t levels = 1) {
+            if (levels == 0 || hasColours)
+                return count_solutions(std::numeric_limits<size_t>::max());
+            if (R[header] == header)
+                return 1;
+
+            const index minColumnIndex = chooseColumn();
+            if (S[minColumnIndex] == 0)
+                return 0;
+
+            const auto orbits = rowOrbits(minColumnIndex);
+            coverColumn(minColumnIndex);
+            size_t count = 0;
+            for (const auto &[i, size]: orbits) {
+                for (index j = R[i]; j != i; j = R[j])
+                    commitColumn(j);
+
+                count += size * count_with_symmetry(levels - 1);
 
-            // Cover all the columns in the row.
-            index i  = rowIdx;
-            do {
-                coverColumn(std::forward<Data>(state), state.C[i]);
-                i = state.R[i];
-                //} while (i != initialIdx);
-            } while (i != rowIdx);
+                for (index j = L[i]; j != i; j = L[j])
+                    uncommitColumn(j);
+            }
+            uncoverColumn(minColumnIndex);
+            return count;
         }
 
         /**
-         * Given a node index for a node in a row, remove the row from the partial solution.
+         * Count the solutions, splitting the remaining problem into independent parts and remembering the counts of
+         * the parts already seen. The remaining problem is split into the components of the graph on the columns
+         * in which two columns are adjacent if a row that can still be chosen contains both: the components are
+         * solved independently and their counts multiplied. The count of a component depends only on its set of
+         * columns, so the counts are kept in a table keyed by it, and a component reached again by another path of
+         * the search is not searched again. To make components recur, the search branches on the first primary
+         * column of a component rather than the one with the fewest rows, unless a column has at most one row: the
+         * covered columns then grow from one end of the problem like a frontier, as in a transfer matrix method.
+         * The state is left unchanged, and any symmetry group is ignored. The count of a component would also
+         * depend on the colours of its purified columns, so for problems with colours, this counts as count does
+         * without a symmetry group.
          *
-         * Note that executing:
-         * 1. useRow(state, idx, sol)
-         * 2. unuseRow(state, idx, sol)
-         * should leave the problem unchhanged.
+         * This pays off for problems that fall apart into small pieces as they are solved, e.g. perfect matchings
+         * and tilings, where the number of solutions can be far too large to visit one by one, at the cost of a
+         * traversal of the remaining problem at every node and the memory for the table.
          *
-         * @param d the DLX state
-         * @param rowIdx the index of a node in the row
-         * @param sol the solution
+         * @return the number of solutions
          */
-        template <typename Data, typename Solution>
-        static constexpr void unuseRow(Data &&state, index rowIdx, Solution &&sol) noexcept {
-            assert(rowIdx > header && rowIdx < HeaderSize + NumNodes);
-            sol[state.RM[rowIdx]] = false;
+        size_t count_memoized() {
+            if (hasColours)
+                return count_solutions(std::numeric_limits<size_t>::max());
+
+            memo_table memo;
+            std::vector<index> primaries;
+            for (index c = R[header]; c != header; c = R[c])
+                primaries.emplace_back(c);
+            return countComponents(primaries, memo);
+        }
+
+        /** DRIVER INTERFACE **/
 
-            // Uncover all the columns in the row.
-            index i = rowIdx;
-            do {
-                uncoverColumn(std::forward<Data>(state), state.C[i]);
-                i = state.L[i];
-            } while (i != rowIdx);
+        /// Determine if every primary column is covered, i.e. the forced rows form a solution.
+        bool complete() const noexcept {
+            return R[header] == header;
         }
 
         /**
-         * Given a formulation produced by the run method, attempt to locate a solution to the exact cover
-         * problem using backtracking on the rows. The general strategy is:
-         * 1. If all columns are covered, solution found.
-         * 2. Otherwise pick the column with the least rows (to minimize branching factor).
-         * 3. Recurse over all possibilities of adding the rows covering thhe column to the answer.
+         * The rows on which the search would branch next, i.e. those of the uncovered primary column with the
+         * fewest rows, for drivers that split the search into subproblems themselves.
          *
-         * The algorithm manipulates the links between rows and columns as per Knuth's DLX paper to efficiently
-         * expand / backtrack.
+         * @return node indices (not offset by the header) of the rows in the column, which can be passed to
+         *         force_row, and which are empty if the state is complete or cannot be completed
+         */
+        std::vector<index> branch_rows() const {
+            std::vector<index> rows;
+            if (complete())
+                return rows;
+
+            const index minColumnIndex = chooseColumn();
+            for (index i = D[minColumnIndex]; i != minColumnIndex; i = D[i])
+                rows.emplace_back(i - HeaderSize);
+            return rows;
+        }
+
+        /**
+         * The row of a node.
          *
-         * @param state the DLX state
-         * @param sol an array representing the solution
-         * @return a solution if one exists, and nullopt if not
+         * @param node a node index (not offset by the header)
+         * @return the row containing the node
          */
-        template <typename Data, typename Solution>
-        static constexpr std::optional<solution> find_solution(Data &&state, Solution &&sol) noexcept {
-            // Check to see if we have a complete solution, i.e if the header only loops to itself.
-            // We could modify this to make a callback for solutions and then iterate over them, but
-            // I'm not sure how we would do this with constexpr.
-            if (state.R[header] == header)
-                return sol;
+        index row_of(index node) const noexcept {
+            return RM[node + HeaderSize];
+        }
 
-            // Choose the column with the smallest number of rows to minimize the branching factor.
-            index minColumnIndex = state.R[header];
-            for (index i = state.R[minColumnIndex]; i != header; i = state.R[i])
-                if (state.S[i] < state.S[minColumnIndex])
-                    minColumnIndex = i;
+    private:
+        size_t numCols;
+        size_t numRows;
+        size_t HeaderSize;
 
-            // If there ae no available rows to cover this column, we cannot extend.
-            if (minColumnIndex == header || state.S[minColumnIndex] == 0)
-                return std::nullopt;
+        // Whether any position has a colour.
+        bool hasColours = false;
 
-            // Cover the column.
-            coverColumn(std::forward<Data>(state), minColumnIndex);
-
-            // Now extend the solution by trying each possible row in the column.
-            for (index i = state.D[minColumnIndex]; i != minColumnIndex; i = state.D[i]) {
-                // I feel like we should be able to use useRow / unuseRow in this for loop, but it doesn't seem to
-                // produce the correct answers in either this or my  Python implementation of DLX.
-//                useRow(std::forward<Data>(state), i, std::forward<Solution>(sol));
-                sol[state.RM[i]] = true;
-                for (index j = state.R[i]; j != i; j = state.R[j])
-                    coverColumn(std::forward<Data>(state), state.C[j]);
-//
-                // Recurse and see if we can find a solution.
-                const auto soln = find_solution(std::forward<Data>(state), std::forward<Solution>(sol));
-                if (soln.has_value())
-                    return soln;
-
-                // Reverse the operation.
-//                unuseRow(std::forward<Data>(state), i, std::forward<Solution>(sol));
-                sol[state.RM[i]] = false;
-                for (index j = state.L[i]; j != i; j = state.L[j])
-                    uncoverColumn(std::forward<Data>(state), state.C[j]);
-//
-            }
-
-            // Uncover the column.
-            uncoverColumn(std::forward<Data>(state), minColumnIndex);
-
-            // If we reach this point, we could not find a row that leads to completion.
-            return std::nullopt;
+        // The nodes of the forced rows, in the order in which they were forced.
+        std::vector<index> forced;
+
+        // The elements of the symmetry group other than the identity, if one has been declared.
+        std::vector<row_permutation> group;
+
+        /**
+         * Partition the rows of a column into classes of rows that are mapped to one another by elements of the
+         * group that fix the set of chosen rows, each of which has the same number of completions.
+         *
+         * @param columnIdx the column
+         * @param sol the chosen rows, as a solution
+         * @param chosen the chosen rows, as a list
+         * @return a node of a representative row of each class, with the size of the class
+         */
+        std::vector<std::pair<index, size_t>> rowClasses(index columnIdx, const solution &sol,
+                                                         const std::vector<index> &chosen) const {
+            std::vector<index> nodes;
+            std::vector<index> position(numRows, numRows);
+            for (index i = D[columnIdx]; i != columnIdx; i = D[i]) {
+                position[RM[i]] = nodes.size();
+                nodes.emplace_back(i);
+            }
+
+            std::vector<index> parent(nodes.size());
+            for (index p = 0; p < nodes.size(); ++p)
+                parent[p] = p;
+            const auto find = [&parent](index p) {
+                while (parent[p] != p)
+                    p = parent[p] = parent[parent[p]];
+                return p;
+            };
+
+            for (const auto &g: group) {
+                if (!std::all_of(chosen.cbegin(), chosen.cend(), [&](index r) { return sol[g[r]]; }))
+                    continue;
+                for (index p = 0; p < nodes.size(); ++p) {
+                    const auto image = position[g[RM[nodes[p]]]];
+                    if (image < nodes.size())
+                        parent[find(p)] = find(image);
+                }
+            }
+
+            std::vector<std::pair<index, size_t>> classes;
+            std::vector<size_t> classOf(nodes.size(), nodes.size());
+            for (index p = 0; p < nodes.size(); ++p) {
+                const auto root = find(p);
+                if (classOf[root] == nodes.size()) {
+                    classOf[root] = classes.size();
+                    classes.emplace_back(nodes[p], 0);
+                }
+                ++classes[classOf[root]].second;
+            }
+            return classes;
+        }
+
+        /// See find_solution, trying one row of each class of rowClasses.
+        bool findWithGroup(solution &sol, std::vector<index> &chosen) {
+            if (R[header] == header)
+                return true;
+
+            const index minColumnIndex = chooseColumn();
+            if (S[minColumnIndex] == 0)
+                return false;
+
+            const auto classes = rowClasses(minColumnIndex, sol, chosen);
+            coverColumn(minColumnIndex);
+            bool found = false;
+            for (size_t c = 0; c < classes.size() && !found; ++c) {
+                const auto i = classes[c].first;
+                sol[RM[i]] = true;
+                chosen.emplace_back(RM[i]);
+                for (index j = R[i]; j != i; j = R[j])
+                    commitColumn(j);
+
+                found = findWithGroup(sol, chosen);
+                if (!found)
+                    sol[RM[i]] = false;
+                chosen.pop_back();
+
+                for (index j = L[i]; j != i; j = L[j])
+                    uncommitColumn(j);
+            }
+            uncoverColumn(minColumnIndex);
+            return found;
+        }
+
+        /// See count_solutions, trying one row of each class of rowClasses and weighting by its size.
+        size_t countWithGroup(solution &sol, std::vector<index> &chosen, size_t limit) {
+            if (R[header] == header)
+                return 1;
+
+            const index minColumnIndex = chooseColumn();
+            if (S[minColumnIndex] == 0)
+                return 0;
+
+            const auto classes = rowClasses(minColumnIndex, sol, chosen);
+            coverColumn(minColumnIndex);
+            size_t count = 0;
+            for (size_t c = 0; c < classes.size() && count < limit; ++c) {
+                const auto [i, size] = classes[c];
+                sol[RM[i]] = true;
+                chosen.emplace_back(RM[i]);
+                for (index j = R[i]; j != i; j = R[j])
+                    commitColumn(j);
+
+                count += size * countWithGroup(sol, chosen, limit - count);
+
+                sol[RM[i]] = false;
+                chosen.pop_back();
+                for (index j = L[i]; j != i; j = L[j])
+                    uncommitColumn(j);
+            }
+            uncoverColumn(minColumnIndex);
+            return count;
         }
 
         /**
-         * Initialize the problem by taking the array of positions and populating the DLX array.
-         * These define the rows that comprise the subets for the exact cover.
+         * Partition the rows of a column into orbits under the automorphisms of the remaining problem that fix the
+         * column. The remaining problem consists of the rows that can still be chosen, i.e. those in uncovered
+         * primary columns, and the columns that they or the uncovered primary columns contain.
          *
-         * @param positions the positions that describe the subsets
-         * @return data object representing the DLX problem
+         * @param columnIdx the column
+         * @return a node of a representative row in the column for each orbit, with the size of the orbit
          */
-        static constexpr data init(const position_array<NumNodes> &positions) noexcept {
-            data d{};
+        std::vector<std::pair<index, size_t>> rowOrbits(index columnIdx) const {
+            // Number the rows and columns of the remaining problem as vertices.
+            const auto none = std::numeric_limits<index>::max();
+            std::vector<index> rowVertex(numRows, none);
+            std::vector<index> columnVertex(numCols, none);
+            coloured_graph g;
+            const auto addVertex = [&g](size_t colour) {
+                g.adjacency.emplace_back();
+                g.colours.emplace_back(colour);
+                return g.adjacency.size() - 1;
+            };
+
+            for (index c = R[header]; c != header; c = R[c])
+                columnVertex[c] = addVertex(c == columnIdx ? 0 : 1);
+            for (index c = R[header]; c != header; c = R[c])
+                for (index i = D[c]; i != c; i = D[i]) {
+                    if (rowVertex[RM[i]] != none) continue;
+                    const auto row = rowVertex[RM[i]] = addVertex(3);
+
+                    index j = i;
+                    do {
+                        // Columns not yet seen are secondary.
+                        if (columnVertex[C[j]] == none)
+                            columnVertex[C[j]] = addVertex(2);
+                        g.adjacency[row].emplace_back(columnVertex[C[j]]);
+                        g.adjacency[columnVertex[C[j]]].emplace_back(row);
+                        j = R[j];
+                    } while (j != i);
+                }
+
+            // Find the orbits of the automorphisms, which all fix the column, as it has its own colour.
+            const auto automorphisms = canonical_labeling(g).automorphisms;
+            std::vector<index> parent(g.adjacency.size());
+            for (index v = 0; v < parent.size(); ++v)
+                parent[v] = v;
+            const auto find = [&parent](index v) {
+                while (parent[v] != v)
+                    v = parent[v] = parent[parent[v]];
+                return v;
+            };
+            for (const auto &gamma: automorphisms)
+                for (index v = 0; v < parent.size(); ++v)
+                    parent[find(v)] = find(gamma[v]);
 
-            // Create the header data.
-            for (index i = 0; i < HeaderSize; ++i) {
-                //d.T[i] = columnTypes[i];
-                d.U[i] = i;
-                d.D[i] = i;
-                d.C[i] = i;
-                d.S[i] = 0;
-                d.RM[i] = NumRows;
+            std::vector<std::pair<index, size_t>> orbits;
+            std::vector<size_t> orbitOf(g.adjacency.size(), none);
+            for (index i = D[columnIdx]; i != columnIdx; i = D[i]) {
+                const auto root = find(rowVertex[RM[i]]);
+                if (orbitOf[root] == none) {
+                    orbitOf[root] = orbits.size();
+                    orbits.emplace_back(i, 0);
+                }
+                ++orbits[orbitOf[root]].second;
             }
+            return orbits;
+        }
 
-            // Do the L-R linking of the columns.
-            for (index i = 0; i <= header; ++i) {
-                d.R[i] = (i + 1) % HeaderSize;
-                d.L[i] = (i - 1 + HeaderSize) % HeaderSize;
+        /// Enumerate the solutions, as count_solutions counts them.
+        template<typename Callback>
+        size_t enumerate_solutions(solution &sol, Callback &callback) {
+            if (R[header] == header) {
+                callback(static_cast<const solution&>(sol));
+                return 1;
             }
 
-            // Now handle the rows.
-            index rowIdx = 0;
-            while (rowIdx < NumNodes) {
-                // Find the start and end positions of this row.
-                const index rowNumber = positions[rowIdx].first;
+            const index minColumnIndex = chooseColumn();
+            if (S[minColumnIndex] == 0)
+                return 0;
 
-                const index rowStartIdx = rowIdx;
-                index rowEndIdx = rowIdx;
-                while (rowEndIdx < NumNodes && positions[rowEndIdx].first == rowNumber)
-                    ++rowEndIdx;
+            coverColumn(minColumnIndex);
+            size_t count = 0;
+            for (index i = D[minColumnIndex]; i != minColumnIndex; i = D[i]) {
+                sol[RM[i]] = true;
+                for (index j = R[i]; j != i; j = R[j])
+                    commitColumn(j);
 
-                // The row goes from [rowStartIdx, rowEndIdx), so link the nodes.
-                for (index idx = rowStartIdx; idx < rowEndIdx; ++idx) {
-                    const auto[row, column] = positions[idx];
-                    const index posIdx = HeaderSize + idx;
+                count += enumerate_solutions(sol, callback);
 
-                    // Set the row and column for the new node.
-                    d.C[posIdx] = column;
-                    d.RM[posIdx] = rowNumber;
+                sol[RM[i]] = false;
+                for (index j = L[i]; j != i; j = L[j])
+                    uncommitColumn(j);
+            }
+            uncoverColumn(minColumnIndex);
+            return count;
+        }
 
-                    // Link to bottom of column, with up pointing to col's previous up, and down to header.
-                    d.U[posIdx] = d.U[column];
-                    d.D[posIdx] = column;
+        /// The counts of the components seen by count_memoized.
+        using memo_table = std::unordered_map<details::column_set, size_t, details::column_set_hash>;
 
-                    // Adjust the header to include the new entry.
-                    d.D[d.U[column]] = posIdx;
-                    d.U[column] = posIdx;
+        /// Determine if a column is an uncovered primary column, i.e. still linked into the header.
+        bool isUncoveredPrimary(index columnIdx) const noexcept {
+            // The secondary columns link only to themselves.
+            return L[columnIdx] != columnIdx && R[L[columnIdx]] == columnIdx;
+        }
 
-                    // Add 1 to the size of the column.
-                    ++d.S[column];
+        /**
+         * Count the solutions of the part of the remaining problem containing the given primary columns, as the
+         * product of the counts of its components.
+         *
+         * @param primaries the primary columns of the part, all uncovered
+         * @param memo the counts of the components seen so far
+         * @return the number of solutions of the part
+         */
+        size_t countComponents(const std::vector<index> &primaries, memo_table &memo) {
+            // Find the components by a traversal through the rows, marking the columns with their component.
+            const auto none = std::numeric_limits<size_t>::max();
+            std::vector<size_t> component(numCols, none);
+            size_t total = 1;
+            for (const auto start: primaries) {
+                if (component[start] != none)
+                    continue;
 
-                    // Link left to previous, if there is one, and right to first in row.
-                    d.L[posIdx] = idx > rowStartIdx ? posIdx - 1 : posIdx;
-                    d.R[posIdx] = rowStartIdx + HeaderSize;
+                const auto id = start;
+                details::column_set columns((numCols + details::WordBits - 1) / details::WordBits, 0);
+                std::vector<index> componentPrimaries;
+                std::vector<index> stack{start};
+                component[start] = id;
+                while (!stack.empty()) {
+                    const auto c = stack.back();
+                    stack.pop_back();
+                    columns[c / details::WordBits] |= std::uint64_t{1} << (c % details::WordBits);
+                    if (isUncoveredPrimary(c))
+                        componentPrimaries.emplace_back(c);
 
-                    // Adjust right and left links of this node to point to this node.
-                    d.L[d.R[posIdx]] = posIdx;
-                    d.R[d.L[posIdx]] = posIdx;
+                    for (index i = D[c]; i != c; i = D[i])
+                        for (index j = R[i]; j != i; j = R[j])
+                            if (component[C[j]] == none) {
+                                component[C[j]] = id;
+                                stack.emplace_back(C[j]);
+                            }
                 }
 
-                rowIdx = rowEndIdx;
+                std::sort(componentPrimaries.begin(), componentPrimaries.end());
+                total *= countComponent(componentPrimaries, std::move(columns), memo);
+                if (total == 0)
+                    break;
             }
-            return std::move(d);
+            return total;
         }
 
         /**
-         * Create the solution and initialize it.
-         * @return empty solution array
+         * Count the solutions of a component of the remaining problem, looking its count up in the memo table.
+         *
+         * @param primaries the primary columns of the component
+         * @param columns the columns of the component, as the key of the memo table
+         * @param memo the counts of the components seen so far
+         * @return the number of solutions of the component
          */
-        static constexpr solution init_solution() noexcept {
-            solution sol{};
-            for (auto &s: sol)
-                s = false;
-            return std::move(sol);
+        size_t countComponent(const std::vector<index> &primaries, details::column_set &&columns, memo_table &memo) {
+            if (primaries.empty())
+                return 1;
+            if (const auto it = memo.find(columns); it != memo.end())
+                return it->second;
+
+            index columnIdx = primaries.front();
+            for (const auto c: primaries)
+                if (S[c] <= 1) {
+                    columnIdx = c;
+                    break;
+                }
+
+            size_t count = 0;
+            if (S[columnIdx] > 0) {
+                coverColumn(columnIdx);
+                for (index i = D[columnIdx]; i != columnIdx; i = D[i]) {
+                    for (index j = R[i]; j != i; j = R[j])
+                        commitColumn(j);
+
+                    std::vector<index> remaining;
+                    for (const auto c: primaries)
+                        if (isUncoveredPrimary(c))
+                            remaining.emplace_back(c);
+                    count += countComponents(remaining, memo);
+
+                    for (index j = L[i]; j != i; j = L[j])
+                        uncommitColumn(j);
+                }
+                uncoverColumn(columnIdx);
+            }
+
+            memo.emplace(std::move(columns), count);
+            return count;
         }
+    };
+
+    /// A row supplied on demand by the oracle of LazyDLX: the columns that it covers.
+    using lazy_row = std::vector<index>;
 
+    /**
+     * An exact cover search for problems whose rows are defined implicitly and are far too many to materialize,
+     * e.g. the C(v, k) blocks of a Steiner system for large v. Instead of linking the rows into a matrix, the
+     * search asks an oracle for the rows that cover a column:
+     *
+     *     oracle(column, covered, rows)
+     *
+     * must append to rows every row that contains the column and no covered column, given the vector covered of
+     * flags for all numCols columns. Only the rows of the current partial solution are ever held in memory.
+     *
+     * As in DLX, the first numPrimaryCols columns are primary and the rest secondary, and the search branches on
+     * the uncovered primary column with the fewest live rows, stopping early at a column with at most one. Every
+     * node of the search queries the oracle for every uncovered primary column, so this trades time for space,
+     * and is worthwhile only when the rows cannot be held in memory.
+     *
+     * @tparam Oracle the type of the oracle
+     */
+    template<typename Oracle>
+    class LazyDLX final {
     public:
-        DLX() = delete;
+        /** OUTPUT **/
+        using solution = std::vector<lazy_row>;
 
         /**
-         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r, run the
-         * exact cover problem using Knuth's dancing links algorithm.
+         * Create the search.
          *
-         * @param positions list of the positions describing the subsets
-         * @return the first solution found if one exists, or nullopt otherwise
+         * @param numCols the number of columns
+         * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+         * @param oracle the oracle that supplies the live rows covering a column
          */
-        static constexpr std::optional<solution> run(const position_array<NumNodes> &positions) noexcept {
-            return find_solution(init(positions), init_solution());
+        LazyDLX(size_t numCols, size_t numPrimaryCols, Oracle oracle):
+                numPrimaryCols{numPrimaryCols}, covered(numCols, false), oracle{std::move(oracle)} {
+            assert(numPrimaryCols <= numCols);
         }
 
         /**
-         * Given a set of "positions" of the form (r,c) indicating that element c is in subset r,
-         * and a set of rows to force into the final solution, run the  exact cover problem using Knuth's
-         * dancing links algorithm.
+         * Find a solution.
          *
-         * @param positions list of the positions describing the subsets
-         * @param fixed_rows a list of fixed rows (not offset by the header)
-         * @return the first solution found if one exists, or nullopt otherwise
+         * @return the rows of the first solution found if one exists, or nullopt otherwise
          */
-        template<size_t NumFixedRows>
-        static constexpr std::optional<solution> run(const position_array<NumNodes> &positions,
-                const std::array<size_t, NumFixedRows> &fixed_rows) noexcept {
-            auto state = init(positions);
+        std::optional<solution> run() {
+            solution sol;
+            if (!find_solution(sol))
+                return std::nullopt;
 
-            // Initialize the solution.
-            auto sol = init_solution();
+            // Leave the search as we found it.
+            for (const auto &row: sol)
+                setRow(row, false);
+            return sol;
+        }
 
-            for (const auto row: fixed_rows)
-                useRow(state, row + HeaderSize, sol);
-            return find_solution(state, sol);
+        /**
+         * Count the solutions, stopping once limit of them have been found.
+         *
+         * @param limit the number of solutions after which to stop searching
+         * @return the number of solutions, capped at limit
+         */
+        size_t count(size_t limit = std::numeric_limits<size_t>::max()) {
+            return count_solutions(limit);
+        }
+
+    private:
+        size_t numPrimaryCols;
+        std::vector<bool> covered;
+        Oracle oracle;
+
+        /**
+         * Find the uncovered primary column with the fewest live rows, and those rows.
+         *
+         * @param rows the live rows of the column, on return
+         * @return false if all primary columns are covered, and true otherwise
+         */
+        bool chooseColumn(std::vector<lazy_row> &rows) {
+            bool found = false;
+            std::vector<lazy_row> candidates;
+            for (index c = 0; c < numPrimaryCols; ++c) {
+                if (covered[c]) continue;
+
+                candidates.clear();
+                oracle(c, static_cast<const std::vector<bool>&>(covered), candidates);
+                if (!found || candidates.size() < rows.size()) {
+                    found = true;
+                    rows.swap(candidates);
+                    if (rows.size() <= 1)
+                        break;
+                }
+            }
+            return found;
+        }
+
+        /// Mark the columns of a row as covered or uncovered.
+        void setRow(const lazy_row &row, bool value) noexcept {
+            for (const auto c: row) {
+                assert(covered[c] != value);
+                covered[c] = value;
+            }
+        }
+
+        /// See DLX::find_solution.
+        bool find_solution(solution &sol) {
+            std::vector<lazy_row> rows;
+            if (!chooseColumn(rows))
+                return true;
+
+            for (auto &row: rows) {
+                setRow(row, true);
+                sol.emplace_back(std::move(row));
+                if (find_solution(sol))
+                    return true;
+                setRow(sol.back(), false);
+                sol.pop_back();
+            }
+            return false;
+        }
+
+        /// See DLX::count_solutions.
+        size_t count_solutions(size_t limit) {
+            std::vector<lazy_row> rows;
+            if (!chooseColumn(rows))
+                return 1;
+
+            size_t count = 0;
+            for (size_t i = 0; i < rows.size() && count < limit; ++i) {
+                setRow(rows[i], true);
+                count += count_solutions(limit - count);
+                setRow(rows[i], false);
+            }
+            return count;
         }
     };
+
+    /**
+     * Run task(i) for every i in [0, count) on up to the given number of threads, each of which repeatedly claims
+     * the next unclaimed index. This is the basis of the parallel drivers: since the DLX state is modified by the
+     * search, each task must work on its own state.
+     *
+     * @param count the number of tasks
+     * @param threads the maximum number of threads to use, including the calling thread
+     * @param task the task to run, taking the index as a parameter
+     */
+    template<typename Task>
+    void parallel_for(size_t count, size_t threads, Task &&task) {
+        std::atomic<size_t> next{0};
+        const auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++)
+                task(i);
+        };
+
+        threads = std::max<size_t>(1, std::min(threads, count));
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < threads; ++t)
+            pool.emplace_back(worker);
+        worker();
+        for (auto &thread: pool)
+            thread.join();
+    }
+
+    /**
+     * Verify that a set of rows is a solution of the problem given by run-time positions, as DLX::verify does.
+     *
+     * @param numCols the number of columns
+     * @param positions the positions describing the subsets
+     * @param sol the rows to verify, e.g. as returned by RuntimeDLX::run
+     * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+     * @return true if sol is a solution, and false otherwise
+     */
+    inline bool verify_cover(size_t numCols, const position_vector &positions, const std::vector<bool> &sol,
+                             size_t numPrimaryCols) {
+        std::vector<std::uint64_t> covered((numCols + details::WordBits - 1) / details::WordBits);
+        return details::verifyCover(positions, numCols, numPrimaryCols, sol, covered);
+    }
+
+    /**
+     * Verify that a set of rows is a solution of a problem in which all columns are primary.
+     *
+     * @param numCols the number of columns
+     * @param positions the positions describing the subsets
+     * @param sol the rows to verify, e.g. as returned by RuntimeDLX::run
+     * @return true if sol is a solution, and false otherwise
+     */
+    inline bool verify_cover(size_t numCols, const position_vector &positions, const std::vector<bool> &sol) {
+        return verify_cover(numCols, positions, sol, numCols);
+    }
+
+    /**
+     * Verify that a set of rows is a solution of a problem with colours: every primary column is covered exactly
+     * once, and every secondary column either at most once by a position without a colour, or by any number of
+     * positions with the same colour.
+     *
+     * @param numCols the number of columns
+     * @param positions the positions describing the subsets
+     * @param sol the rows to verify, e.g. as returned by RuntimeDLX::run
+     * @param numPrimaryCols the number of primary columns, which come before the secondary columns
+     * @param colours the colours of the positions, as given to RuntimeDLX
+     * @return true if sol is a solution, and false otherwise
+     */
+    inline bool verify_cover(size_t numCols, const position_vector &positions, const std::vector<bool> &sol,
+                             size_t numPrimaryCols, const colour_vector &colours) {
+        // The colour given to each column so far, if it is covered.
+        const auto none = std::numeric_limits<size_t>::max();
+        std::vector<size_t> given(numCols, none);
+        for (size_t idx = 0; idx < positions.size(); ++idx) {
+            const auto [row, column] = positions[idx];
+            if (!sol[row]) continue;
+            assert(0 <= column && static_cast<size_t>(column) < numCols);
+
+            const auto colour = colours.empty() ? 0 : colours[idx];
+            auto &g = given[column];
+            if (g != none && (g == 0 || g != colour))
+                return false;
+            g = colour;
+        }
+        return std::all_of(given.cbegin(), given.cbegin() + numPrimaryCols, [none](size_t g) { return g != none; });
+    }
+
+    /**
+     * Split the search of a problem into subproblems, by expanding its search tree breadth first, branching as the
+     * search would, until there are at least wanted subproblems or no more branching is possible. The solutions
+     * of the problem are partitioned among the subproblems.
+     *
+     * @param base the problem
+     * @param wanted the number of subproblems to aim for
+     * @return the subproblems, each as the node indices (not offset by the header) of the rows to force into base
+     */
+    inline std::vector<std::vector<index>> split_search(const RuntimeDLX &base, size_t wanted) {
+        std::vector<std::vector<index>> tasks{{}};
+        bool split = true;
+        while (split && tasks.size() < wanted) {
+            split = false;
+            std::vector<std::vector<index>> next;
+            for (const auto &task: tasks) {
+                auto solver = base;
+                for (const auto node: task)
+                    solver.force_row(node);
+
+                // Complete subproblems cannot be split further, and dead ends are dropped.
+                if (solver.complete()) {
+                    next.emplace_back(task);
+                    continue;
+                }
+                for (const auto node: solver.branch_rows()) {
+                    split = true;
+                    next.emplace_back(task);
+                    next.back().emplace_back(node);
+                }
+            }
+            tasks = std::move(next);
+        }
+        return tasks;
+    }
+
+    /**
+     * Count the solutions of a problem on up to the given number of threads, each of which works on its own copy
+     * of the problem.
+     *
+     * @param base the problem
+     * @param threads the maximum number of threads to use
+     * @return the number of solutions
+     */
+    inline size_t parallel_count(const RuntimeDLX &base, size_t threads) {
+        const auto tasks = split_search(base, 16 * std::max<size_t>(1, threads));
+        std::vector<size_t> counts(tasks.size());
+        parallel_for(tasks.size(), threads, [&](size_t i) {
+            auto solver = base;
+            for (const auto node: tasks[i])
+                solver.force_row(node);
+            counts[i] = solver.count();
+        });
+
+        size_t total = 0;
+        for (const auto c: counts)
+            total += c;
+        return total;
+    }
+
+    /**
+     * Call callback with every solution of a problem, on up to the given number of threads, each of which works on
+     * its own copy of the problem. The callback is called concurrently, so it must be thread-safe.
+     *
+     * @param base the problem
+     * @param threads the maximum number of threads to use
+     * @param callback the function to call with each solution
+     */
+    template<typename Callback>
+    void parallel_for_each_solution(const RuntimeDLX &base, size_t threads, Callback &&callback) {
+        const auto tasks = split_search(base, 16 * std::max<size_t>(1, threads));
+        parallel_for(tasks.size(), threads, [&](size_t i) {
+            auto solver = base;
+            for (const auto node: tasks[i])
+                solver.force_row(node);
+            solver.for_each_solution(callback);
+        });
+    }
 }
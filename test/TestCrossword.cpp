@@ -0,0 +1,127 @@
+/**
+ * TestCrossword.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestCrossword.h"
+#include "TestTiming.h"
+
+using namespace crossword;
+
+namespace {
+    /**
+     * Determine if a grid is a filling of a template: the given letters are kept, and the words of the slots are
+     * all in the dictionary, and distinct if required.
+     */
+    bool isFill(const grid &g, const grid &filled, const std::vector<std::string> &words, bool distinct = true) {
+        if (filled.size() != g.size())
+            return false;
+        for (size_t i = 0; i < g.size(); ++i)
+            for (size_t j = 0; j < g[i].size(); ++j)
+                if (g[i][j] != '.' && g[i][j] != filled[i][j])
+                    return false;
+
+        const std::set<std::string> dictionary{words.cbegin(), words.cend()};
+        std::set<std::string> used;
+        for (const auto &s: findSlots(g)) {
+            std::string word;
+            for (size_t k = 0; k < s.length; ++k) {
+                const auto [i, j] = cellOf(s, k);
+                word += filled[i][j];
+            }
+            if (!dictionary.count(word) || (!used.insert(word).second && distinct))
+                return false;
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Slots of a grid") {
+    const grid g{
+        "...#",
+        "....",
+        "#..."
+    };
+    const auto slots = findSlots(g);
+    REQUIRE(slots.size() == 7);
+    REQUIRE(std::count_if(slots.cbegin(), slots.cend(), [](const auto &s) { return s.across; }) == 3);
+    REQUIRE(slots[1].length == 4);
+    REQUIRE(slots[3].row == 0);
+    REQUIRE(slots[3].column == 0);
+    REQUIRE(slots[3].length == 2);
+    REQUIRE(cellOf(slots[6], 1) == std::pair<size_t, size_t>{2, 3});
+}
+
+TEST_CASE("Filling word squares") {
+    // A word square, whose rows and columns are the same words.
+    const grid square{"...", "...", "..."};
+    const std::vector<std::string> words{"bit", "ice", "ten", "tic", "bet"};
+    REQUIRE(count_fills(square, words, false) == 1);
+    const auto filled = fill_grid(square, words, false);
+    REQUIRE(filled);
+    print_grid(*filled);
+    REQUIRE(isFill(square, *filled, words, false));
+
+    // The square uses every word twice.
+    REQUIRE(count_fills(square, words) == 0);
+
+    // Given letters restrict the words that fit.
+    REQUIRE(count_fills({"b..", "...", "..."}, words, false) == 1);
+    REQUIRE(count_fills({"t..", "...", "..."}, words, false) == 0);
+
+    // The counts that cannot use colours fall back to the plain search rather than miscount.
+    auto solver = crosswordSolver(makeCrossword(square, words, false));
+    REQUIRE(solver.count_with_symmetry() == 1);
+    REQUIRE(solver.count_memoized() == 1);
+
+    // Only lowercase letters have colours.
+    REQUIRE_THROWS_AS(count_fills(square, {"bit", "i_e", "ten"}), std::invalid_argument);
+    REQUIRE_THROWS_AS(count_fills(square, {"bit", "Ice", "ten"}), std::invalid_argument);
+}
+
+TEST_CASE("Filling generated grids") {
+    const auto g = randomGrid(9, 16, 1);
+    print_grid(g);
+    for (const auto &s: findSlots(g))
+        REQUIRE(s.length >= 3);
+
+    const auto words = plantedDictionary(g, 2000, 1);
+    REQUIRE(words.size() == 2000);
+    const auto filled = fill_grid(g, words);
+    REQUIRE(filled);
+    print_grid(*filled);
+    REQUIRE(isFill(g, *filled, words));
+
+    // A grid without slots has nothing to plant.
+    REQUIRE(plantedDictionary({"#.", ".#"}, 10, 1).empty());
+
+    // The search respects the colours of the cells.
+    const auto f = makeCrossword(g, words);
+    auto solver = crosswordSolver(f);
+    const auto sol = solver.run();
+    REQUIRE(sol);
+    REQUIRE(dlx::verify_cover(f.columns, f.positions, *sol, f.primaryColumns, f.colours));
+}
+
+TEST_CASE("Fill a generated grid from generated dictionaries", "[.benchmark]") {
+    const auto g = randomGrid(13, 40, 2);
+    print_grid(g);
+    for (const size_t size: {10000, 30000, 60000}) {
+        const auto words = plantedDictionary(g, size, 2);
+        const auto f = makeCrossword(g, words);
+
+        const auto [filled, elapsed] = timing::timed([&] { return fill_grid(g, words); });
+        std::clog << size << " words, " << f.options.size() << " options: filled in " << elapsed << "s" << std::endl;
+        REQUIRE(filled);
+        REQUIRE(isFill(g, *filled, words));
+    }
+}
@@ -0,0 +1,299 @@
+/**
+ * TestCrossword.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace crossword {
+    /// A grid: rows of equal length, with '#' for blocks, '.' for empty cells, and lowercase letters for given ones.
+    using grid = std::vector<std::string>;
+
+    /// A slot of a grid: a maximal run of at least two open cells across or down, starting at (row, column).
+    struct slot {
+        size_t row;
+        size_t column;
+        bool across;
+        size_t length;
+    };
+
+    /// The cell at position k of a slot.
+    inline std::pair<size_t, size_t> cellOf(const slot &s, size_t k) noexcept {
+        return s.across ? std::pair{s.row, s.column + k} : std::pair{s.row + k, s.column};
+    }
+
+    /// Find the slots of a grid, the across ones first, in reading order.
+    inline std::vector<slot> findSlots(const grid &g) {
+        const auto height = g.size();
+        const auto width = height ? g.front().size() : 0;
+        const auto isOpen = [&g](size_t i, size_t j) { return g[i][j] != '#'; };
+
+        std::vector<slot> slots;
+        for (const bool across: {true, false}) {
+            const auto lines = across ? height : width;
+            const auto length = across ? width : height;
+            for (size_t line = 0; line < lines; ++line)
+                for (size_t k = 0; k < length;) {
+                    const auto open = [&](size_t x) { return across ? isOpen(line, x) : isOpen(x, line); };
+                    if (!open(k)) {
+                        ++k;
+                        continue;
+                    }
+                    size_t end = k;
+                    while (end < length && open(end))
+                        ++end;
+                    if (end - k >= 2)
+                        slots.push_back(across ? slot{line, k, true, end - k} : slot{k, line, false, end - k});
+                    k = end;
+                }
+        }
+        return slots;
+    }
+
+    /**
+     * The formulation of the fillings of a grid from a dictionary, as an exact cover problem with colours. The
+     * columns consist of:
+     * 1. A primary entry for each slot, which represents that the slot is filled.
+     * 2. If the words must be distinct, a secondary entry for each word, which represents that the word is used.
+     * 3. A secondary entry for each cell of the grid, whose colour is the letter in the cell.
+     * The rows are the words that fit each slot: they have the right length and agree with the given letters.
+     */
+    struct formulation {
+        std::vector<slot> slots;
+        std::vector<std::pair<size_t, size_t>> options;
+        size_t columns;
+        size_t primaryColumns;
+        dlx::position_vector positions;
+        dlx::colour_vector colours;
+    };
+
+    /// The colour of a lowercase letter, from 1 to 26, as 0 means that a cell is uncoloured.
+    constexpr size_t colourOf(char ch) noexcept {
+        return static_cast<size_t>(ch - 'a') + 1;
+    }
+
+    /**
+     * Create the formulation of the fillings of a grid.
+     *
+     * @param g the grid
+     * @param words the dictionary, in lowercase
+     * @param distinct true if no word may be used twice
+     * @return the formulation
+     * @throws std::invalid_argument if a word has a character other than a lowercase letter
+     */
+    inline formulation makeCrossword(const grid &g, const std::vector<std::string> &words, bool distinct = true) {
+        for (const auto &word: words)
+            if (!std::all_of(word.cbegin(), word.cend(), [](char ch) { return 'a' <= ch && ch <= 'z'; }))
+                throw std::invalid_argument("crossword words may only have the letters a to z: " + word);
+
+        const auto width = g.empty() ? 0 : g.front().size();
+        formulation f{findSlots(g), {}, 0, 0, {}, {}};
+        f.primaryColumns = f.slots.size();
+        const auto cellBase = f.primaryColumns + (distinct ? words.size() : 0);
+        f.columns = cellBase + g.size() * width;
+
+        for (size_t s = 0; s < f.slots.size(); ++s) {
+            const auto &sl = f.slots[s];
+            for (size_t w = 0; w < words.size(); ++w) {
+                const auto &word = words[w];
+                if (word.size() != sl.length)
+                    continue;
+
+                bool fits = true;
+                for (size_t k = 0; k < sl.length && fits; ++k) {
+                    const auto [i, j] = cellOf(sl, k);
+                    fits = g[i][j] == '.' || g[i][j] == word[k];
+                }
+                if (!fits)
+                    continue;
+
+                const auto row = static_cast<int>(f.options.size());
+                f.positions.emplace_back(row, static_cast<int>(s));
+                f.colours.emplace_back(0);
+                if (distinct) {
+                    f.positions.emplace_back(row, static_cast<int>(f.primaryColumns + w));
+                    f.colours.emplace_back(0);
+                }
+                for (size_t k = 0; k < sl.length; ++k) {
+                    const auto [i, j] = cellOf(sl, k);
+                    f.positions.emplace_back(row, static_cast<int>(cellBase + i * width + j));
+                    f.colours.emplace_back(colourOf(word[k]));
+                }
+                f.options.emplace_back(s, w);
+            }
+        }
+        return f;
+    }
+
+    /// The solver for a formulation.
+    inline dlx::RuntimeDLX crosswordSolver(const formulation &f) {
+        return dlx::RuntimeDLX{f.columns, f.options.size(), f.positions, f.primaryColumns, f.colours};
+    }
+
+    /**
+     * Fill a grid from a dictionary.
+     *
+     * @param g the grid
+     * @param words the dictionary, in lowercase
+     * @param distinct true if no word may be used twice
+     * @return the first filling found, if one exists
+     * @throws std::invalid_argument if a word has a character other than a lowercase letter
+     */
+    inline std::optional<grid> fill_grid(const grid &g, const std::vector<std::string> &words, bool distinct = true) {
+        const auto f = makeCrossword(g, words, distinct);
+        const auto sol = crosswordSolver(f).run();
+        if (!sol)
+            return std::nullopt;
+
+        auto filled = g;
+        for (size_t row = 0; row < sol->size(); ++row)
+            if ((*sol)[row]) {
+                const auto [s, w] = f.options[row];
+                for (size_t k = 0; k < f.slots[s].length; ++k) {
+                    const auto [i, j] = cellOf(f.slots[s], k);
+                    filled[i][j] = words[w][k];
+                }
+            }
+        return filled;
+    }
+
+    /**
+     * Count the fillings of a grid from a dictionary, stopping at limit.
+     *
+     * @param g the grid
+     * @param words the dictionary, in lowercase
+     * @param distinct true if no word may be used twice
+     * @param limit the number of fillings after which to stop searching
+     * @return the number of fillings, capped at limit
+     * @throws std::invalid_argument if a word has a character other than a lowercase letter
+     */
+    inline size_t count_fills(const grid &g, const std::vector<std::string> &words, bool distinct = true,
+                              size_t limit = std::numeric_limits<size_t>::max()) {
+        return crosswordSolver(makeCrossword(g, words, distinct)).count(limit);
+    }
+
+    namespace details {
+        /// The relative frequencies of the letters in English text, in tenths of a percent.
+        constexpr std::array<unsigned, 26> LetterFrequencies {{
+            82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24, 67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1
+        }};
+
+        /// A random letter, drawn with the frequencies of English.
+        template<typename Generator>
+        char randomLetter(Generator &gen) {
+            std::discrete_distribution<size_t> letters{LetterFrequencies.cbegin(), LetterFrequencies.cend()};
+            return static_cast<char>('a' + letters(gen));
+        }
+
+        /// Determine if every slot of a grid has length at least 3.
+        inline bool hasValidRuns(const grid &g) {
+            for (const auto &s: findSlots(g))
+                if (s.length < 3)
+                    return false;
+            return true;
+        }
+    }
+
+    /**
+     * Generate a grid with rotational symmetry by placing pairs of blocks at random, keeping only those that leave
+     * every slot of length at least 3, as in a published crossword.
+     *
+     * @param size the height and width of the grid
+     * @param blocks the number of blocks to aim for
+     * @param seed the seed
+     * @return the grid, with no given letters
+     */
+    inline grid randomGrid(size_t size, size_t blocks, std::uint64_t seed) {
+        std::mt19937_64 gen{seed};
+        std::uniform_int_distribution<size_t> coordinate{0, size - 1};
+        grid g(size, std::string(size, '.'));
+        size_t placed = 0;
+        for (size_t attempt = 0; attempt < 100 * blocks && placed < blocks; ++attempt) {
+            const auto i = coordinate(gen);
+            const auto j = coordinate(gen);
+            if (g[i][j] == '#')
+                continue;
+
+            g[i][j] = g[size - 1 - i][size - 1 - j] = '#';
+            if (details::hasValidRuns(g))
+                placed += i == size - 1 - i && j == size - 1 - j ? 1 : 2;
+            else
+                g[i][j] = g[size - 1 - i][size - 1 - j] = '.';
+        }
+        return g;
+    }
+
+    /**
+     * Generate a dictionary for a grid with a planted filling: the grid is filled with random letters, drawn with
+     * the frequencies of English, and the words of its slots are mixed with random words of the same lengths. The
+     * letters are redrawn until the words of the slots are distinct, so the grid can be filled even if the words
+     * must be distinct.
+     *
+     * @param g the grid
+     * @param size the number of words in the dictionary, which is at least the number of slots
+     * @param seed the seed
+     * @return the dictionary, in random order, which is empty if the grid has no slots
+     */
+    inline std::vector<std::string> plantedDictionary(const grid &g, size_t size, std::uint64_t seed) {
+        std::mt19937_64 gen{seed};
+        const auto slots = findSlots(g);
+        if (slots.empty())
+            return {};
+
+        std::set<std::string> words;
+        while (words.size() < slots.size()) {
+            auto filled = g;
+            for (auto &row: filled)
+                for (auto &ch: row)
+                    if (ch == '.')
+                        ch = details::randomLetter(gen);
+
+            words.clear();
+            for (const auto &s: slots) {
+                std::string word(s.length, ' ');
+                for (size_t k = 0; k < s.length; ++k) {
+                    const auto [i, j] = cellOf(s, k);
+                    word[k] = filled[i][j];
+                }
+                words.insert(word);
+            }
+        }
+
+        // Draw the lengths of the other words as those of the slots are distributed.
+        std::uniform_int_distribution<size_t> slotOf{0, slots.size() - 1};
+        for (size_t attempt = 0; words.size() < size && attempt < 100 * size; ++attempt) {
+            std::string word(slots[slotOf(gen)].length, ' ');
+            for (auto &ch: word)
+                ch = details::randomLetter(gen);
+            words.insert(word);
+        }
+
+        std::vector<std::string> dictionary{words.cbegin(), words.cend()};
+        std::shuffle(dictionary.begin(), dictionary.end(), gen);
+        return dictionary;
+    }
+
+    /// Display a grid to clog.
+    inline void print_grid(const grid &g) noexcept {
+        for (const auto &row: g)
+            std::clog << row << '\n';
+        std::flush(std::clog);
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * TestLangford.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <array>
+#include <iostream>
+#include <thread>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestLangford.h"
+#include "TestTiming.h"
+
+using namespace langford;
+
+namespace {
+    /// The number of Langford sequences of order n up to reversal, for n = 0, ..., 16.
+    constexpr std::array<size_t, 17> langfordCounts{{
+        0, 0, 0, 1, 1, 0, 0, 26, 150, 0, 0, 17792, 108144, 0, 0, 39809640, 326721800
+    }};
+
+    /// The number of Skolem sequences of order n, including reversals, for n = 0, ..., 13.
+    constexpr std::array<size_t, 14> skolemCounts{{
+        0, 1, 0, 0, 6, 10, 0, 0, 504, 2656, 0, 0, 455936, 3040560
+    }};
+
+    /// Determine if seq is a sequence of order n of the given kind.
+    bool isSequence(size_t n, sequence kind, const std::vector<size_t> &seq) {
+        if (seq.size() != 2 * n)
+            return false;
+        for (size_t k = 1; k <= n; ++k) {
+            std::vector<size_t> where;
+            for (size_t i = 0; i < seq.size(); ++i)
+                if (seq[i] == k)
+                    where.emplace_back(i);
+            if (where.size() != 2 || where[1] - where[0] != pairDistance(k, kind))
+                return false;
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Langford sequences") {
+    const auto seq = run_sequence(7, sequence::langford);
+    REQUIRE(seq);
+    print_sequence(*seq);
+    REQUIRE(isSequence(7, sequence::langford, *seq));
+    REQUIRE(!run_sequence(6, sequence::langford));
+
+    for (size_t n = 1; n <= 8; ++n) {
+        REQUIRE(count_sequences(n, sequence::langford) == langfordCounts[n]);
+        REQUIRE(count_sequences(n, sequence::langford, false) == 2 * langfordCounts[n]);
+    }
+
+    // The divisibility conditions rule out the orders 1 and 2 (mod 4) before searching, so check that the
+    // search agrees.
+    REQUIRE(!isAdmissible(6, sequence::langford));
+    REQUIRE(pairingSolver(6, sequence::langford).count() == 0);
+}
+
+TEST_CASE("Skolem sequences") {
+    const auto seq = run_sequence(9, sequence::skolem);
+    REQUIRE(seq);
+    print_sequence(*seq);
+    REQUIRE(isSequence(9, sequence::skolem, *seq));
+    REQUIRE(!run_sequence(7, sequence::skolem));
+
+    REQUIRE(count_sequences(1, sequence::skolem) == 1);
+    for (size_t n = 2; n <= 9; ++n) {
+        REQUIRE(count_sequences(n, sequence::skolem) == skolemCounts[n] / 2);
+        REQUIRE(count_sequences(n, sequence::skolem, false) == skolemCounts[n]);
+    }
+    REQUIRE(pairingSolver(7, sequence::skolem).count() == 0);
+}
+
+TEST_CASE("Count Langford sequences in parallel") {
+    REQUIRE(count_sequences(8, sequence::langford, true, 1) == langfordCounts[8]);
+    REQUIRE(count_sequences(8, sequence::langford, true, 4) == langfordCounts[8]);
+}
+
+TEST_CASE("Count Langford and Skolem sequences", "[.benchmark]") {
+    const auto threads = std::thread::hardware_concurrency();
+    for (const size_t n: {12, 13}) {
+        const auto [count, elapsed] = timing::timed([&] {
+            return count_sequences(n, sequence::skolem, true, threads);
+        });
+        std::clog << "Skolem(" << n << "): " << count << " sequences in " << elapsed << "s" << std::endl;
+        REQUIRE(count == skolemCounts[n] / 2);
+    }
+    for (const size_t n: {11, 12, 15, 16}) {
+        const auto [count, elapsed] = timing::timed([&] {
+            return count_sequences(n, sequence::langford, true, threads);
+        });
+        std::clog << "L(2, " << n << "): " << count << " sequences in " << elapsed << "s" << std::endl;
+        REQUIRE(count == langfordCounts[n]);
+    }
+}
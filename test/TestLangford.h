@@ -0,0 +1,130 @@
+/**
+ * TestLangford.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace langford {
+    /**
+     * The kinds of pairing sequences of order n, i.e. arrangements of two copies of each of 1, ..., n in a
+     * sequence of length 2n:
+     * 1. In a Langford sequence, the two copies of k have k entries between them.
+     * 2. In a Skolem sequence, the two copies of k are k places apart.
+     */
+    enum class sequence {
+        langford,
+        skolem
+    };
+
+    /// The distance between the positions of the two copies of k in a sequence of the given kind.
+    constexpr size_t pairDistance(size_t k, sequence kind) noexcept {
+        return kind == sequence::langford ? k + 1 : k;
+    }
+
+    /// Determine if there is a sequence of order n of the given kind.
+    constexpr bool isAdmissible(size_t n, sequence kind) noexcept {
+        return kind == sequence::langford ? n % 4 == 0 || n % 4 == 3 : n % 4 == 0 || n % 4 == 1;
+    }
+
+    /**
+     * Create the formulation of the sequences of order n of the given kind. The columns consist of:
+     * 1. n entries N_k, which represent that the two copies of k + 1 are placed.
+     * 2. 2n entries P_i, which represent that position i of the sequence is filled.
+     * The rows are the placements of the copies of k at positions i and i + pairDistance(k), in order of k
+     * and then i, and have three nodes each.
+     *
+     * Reversing a sequence gives another sequence, and no sequence is its own reversal unless n = 1. If
+     * breakSymmetry is set, the pair at distance 2 is restricted to the first half of the sequence, so that
+     * only one of every sequence and its reversal remains. As the pair at distance 2 is in positions i and
+     * i + 2, which reversal maps to 2n - 3 - i and 2n - 1 - i, this keeps i <= n - 2.
+     *
+     * @param n the order of the sequences
+     * @param kind the kind of sequences
+     * @param breakSymmetry true if the sequences are to be counted up to reversal
+     * @return the position vector for the formulation
+     */
+    inline dlx::position_vector makePairingPositions(size_t n, sequence kind, bool breakSymmetry = true) {
+        dlx::position_vector positions;
+        int row = 0;
+        for (size_t k = 1; k <= n; ++k) {
+            const auto d = pairDistance(k, kind);
+            for (size_t i = 0; i + d < 2 * n; ++i) {
+                if (breakSymmetry && d == 2 && i + 2 > n)
+                    continue;
+                positions.emplace_back(row, static_cast<int>(k - 1));
+                positions.emplace_back(row, static_cast<int>(n + i));
+                positions.emplace_back(row, static_cast<int>(n + i + d));
+                ++row;
+            }
+        }
+        return positions;
+    }
+
+    /// The solver for the sequences of order n of the given kind, as formulated by makePairingPositions.
+    inline dlx::RuntimeDLX pairingSolver(size_t n, sequence kind, bool breakSymmetry = true) {
+        const auto positions = makePairingPositions(n, kind, breakSymmetry);
+        return dlx::RuntimeDLX{3 * n, positions.size() / 3, positions};
+    }
+
+    /**
+     * Find a sequence of order n of the given kind.
+     *
+     * @param n the order of the sequence
+     * @param kind the kind of sequence
+     * @return the sequence if one exists, and nullopt otherwise
+     */
+    inline std::optional<std::vector<size_t>> run_sequence(size_t n, sequence kind) {
+        if (!isAdmissible(n, kind))
+            return std::nullopt;
+
+        const auto positions = makePairingPositions(n, kind);
+        dlx::RuntimeDLX solver{3 * n, positions.size() / 3, positions};
+        const auto sol = solver.run();
+        if (!sol)
+            return std::nullopt;
+
+        std::vector<size_t> seq(2 * n);
+        for (size_t row = 0; row < sol->size(); ++row)
+            if ((*sol)[row]) {
+                const auto k = positions[3 * row].second + 1;
+                seq[positions[3 * row + 1].second - n] = k;
+                seq[positions[3 * row + 2].second - n] = k;
+            }
+        return seq;
+    }
+
+    /**
+     * Count the sequences of order n of the given kind. The counts grow quickly with n, so for large n, the
+     * search is split into subproblems by the first placements it branches on, which are counted in parallel.
+     *
+     * @param n the order of the sequences
+     * @param kind the kind of sequences
+     * @param breakSymmetry true if the sequences are to be counted up to reversal
+     * @param threads the number of threads to use
+     * @return the number of sequences
+     */
+    inline size_t count_sequences(size_t n, sequence kind, bool breakSymmetry = true,
+                                  size_t threads = std::thread::hardware_concurrency()) {
+        if (!isAdmissible(n, kind))
+            return 0;
+        return dlx::parallel_count(pairingSolver(n, kind, breakSymmetry), threads);
+    }
+
+    /// Display a sequence to clog.
+    inline void print_sequence(const std::vector<size_t> &seq) noexcept {
+        for (const auto k: seq)
+            std::clog << k << ' ';
+        std::clog << '\n';
+        std::flush(std::clog);
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * TestLatinSquare.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <iostream>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestLatinSquare.h"
+#include "TestTiming.h"
+
+using namespace latin;
+
+namespace {
+    /// Determine if a square is a Latin square that agrees with the entries of a partial square.
+    bool completes(const latin_square &partial, const latin_square &sq) {
+        if (sq.size() != partial.size() || !isConsistent(sq))
+            return false;
+        for (size_t i = 0; i < sq.size(); ++i)
+            for (size_t j = 0; j < sq.size(); ++j)
+                if (!sq[i][j] || (partial[i][j] && partial[i][j] != sq[i][j]))
+                    return false;
+        return true;
+    }
+
+    /// The partial square of order n with its first row and column fixed to 1, ..., n.
+    latin_square reducedSquare(size_t n) {
+        latin_square sq(n, std::vector<size_t>(n));
+        for (size_t i = 0; i < n; ++i)
+            sq[0][i] = sq[i][0] = i + 1;
+        return sq;
+    }
+}
+
+TEST_CASE("Count Latin squares") {
+    REQUIRE(count_completions(latin_square(4, std::vector<size_t>(4))) == 576);
+
+    // The reduced Latin squares, with the first row and column in order.
+    REQUIRE(count_completions(reducedSquare(4)) == 4);
+    REQUIRE(count_completions(reducedSquare(5)) == 56);
+    REQUIRE(count_completions(reducedSquare(6)) == 9408);
+}
+
+TEST_CASE("Complete partial Latin squares") {
+    const latin_square partial{{1, 0, 0},
+                               {0, 0, 3},
+                               {0, 0, 0}};
+    const auto sq = complete_square(partial);
+    REQUIRE(sq);
+    REQUIRE(completes(partial, *sq));
+    REQUIRE(count_completions(partial) == 1);
+
+    // Consistent, but with no completion: 1 can go nowhere in the second row.
+    const latin_square stuck{{0, 1},
+                             {2, 0}};
+    REQUIRE(isConsistent(stuck));
+    REQUIRE(!complete_square(stuck));
+
+    // Not consistent.
+    const latin_square clash{{1, 1},
+                             {0, 0}};
+    REQUIRE(!isConsistent(clash));
+    REQUIRE(!complete_square(clash));
+}
+
+TEST_CASE("Random Latin squares") {
+    for (const size_t n: {1, 2, 5, 12}) {
+        const auto sq = randomLatinSquare(n, 17);
+        REQUIRE(completes(sq, sq));
+        REQUIRE(sq == randomLatinSquare(n, 17));
+    }
+    REQUIRE(randomLatinSquare(12, 17) != randomLatinSquare(12, 18));
+}
+
+TEST_CASE("Quasigroups with holes") {
+    const auto sq = randomLatinSquare(15, 3);
+    const auto partial = punchHoles(sq, 0.42, 5);
+
+    size_t holes = 0;
+    for (const auto &row: partial)
+        holes += std::count(row.cbegin(), row.cend(), 0);
+    REQUIRE(holes == 95);
+
+    const auto completion = complete_square(partial);
+    REQUIRE(completion);
+    print_square(*completion);
+    REQUIRE(completes(partial, *completion));
+    REQUIRE(count_completions(punchHoles(sq, 0, 5)) == 1);
+}
+
+TEST_CASE("Complete quasigroups with holes around the phase transition", "[.benchmark]") {
+    constexpr size_t n = 30;
+    for (const double holes: {0.3, 0.36, 0.42, 0.48, 0.54}) {
+        const auto [completed, elapsed] = timing::timed([&] {
+            size_t count = 0;
+            for (std::uint64_t seed = 0; seed < 5; ++seed) {
+                const auto partial = punchHoles(randomLatinSquare(n, seed), holes, seed);
+                const auto completion = complete_square(partial);
+                if (completion && completes(partial, *completion))
+                    ++count;
+            }
+            return count;
+        });
+        std::clog << "order " << n << " with " << holes << " holes: " << elapsed << "s" << std::endl;
+        REQUIRE(completed == 5);
+    }
+}
@@ -0,0 +1,245 @@
+/**
+ * TestLatinSquare.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace latin {
+    /// A partial Latin square of order n, with symbols 1 to n and 0 for empty cells.
+    using latin_square = std::vector<std::vector<size_t>>;
+
+    /**
+     * Create a formulation of the completion of a Latin square of order n, i.e. of a quasigroup of order n.
+     * This is the formulation of Sudoku without the regions. The columns consist of:
+     * 1. n^2 entries O_ij, which represent that cell (i, j) is occupied.
+     * 2. n^2 entries R_is, which represent that symbol s appears in row i.
+     * 3. n^2 entries C_js, which represent that symbol s appears in column j.
+     * The rows are L_ijs, which represent symbol s + 1 in cell (i, j), numbered (i n + j) n + s, and have three
+     * nodes each.
+     *
+     * @param n the order of the square
+     * @return the position vector for the formulation
+     */
+    inline dlx::position_vector makeLatinPositions(size_t n) {
+        dlx::position_vector positions;
+        positions.reserve(3 * n * n * n);
+        int row = 0;
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                for (size_t s = 0; s < n; ++s) {
+                    positions.emplace_back(row, static_cast<int>(i * n + j));
+                    positions.emplace_back(row, static_cast<int>(n * n + i * n + s));
+                    positions.emplace_back(row, static_cast<int>(2 * n * n + j * n + s));
+                    ++row;
+                }
+        return positions;
+    }
+
+    /// The first node of the row for symbol s in cell (i, j) of a square of order n.
+    constexpr size_t toNode(size_t n, size_t i, size_t j, size_t s) noexcept {
+        return 3 * ((i * n + j) * n + s - 1);
+    }
+
+    /**
+     * Determine if a partial Latin square is consistent, i.e. it is square with symbols from 0 to n, and no
+     * symbol appears twice in a row or column.
+     *
+     * @param sq the partial square
+     * @return true if the square is consistent, and false otherwise
+     */
+    inline bool isConsistent(const latin_square &sq) {
+        const auto n = sq.size();
+        std::vector<bool> seen(2 * n * n, false);
+        for (size_t i = 0; i < n; ++i) {
+            if (sq[i].size() != n)
+                return false;
+            for (size_t j = 0; j < n; ++j) {
+                const auto s = sq[i][j];
+                if (!s) continue;
+                if (s > n) return false;
+
+                for (const auto idx: {i * n + s - 1, (n + j) * n + s - 1}) {
+                    if (seen[idx]) return false;
+                    seen[idx] = true;
+                }
+            }
+        }
+        return true;
+    }
+
+    namespace details {
+        /**
+         * Build the solver for the order of a partial square and force its entries.
+         *
+         * @param sq the partial square, which must be consistent
+         * @return the solver with the entries forced
+         */
+        inline dlx::RuntimeDLX latinSolverFor(const latin_square &sq) {
+            const auto n = sq.size();
+            dlx::RuntimeDLX solver{3 * n * n, n * n * n, makeLatinPositions(n)};
+            for (size_t i = 0; i < n; ++i)
+                for (size_t j = 0; j < n; ++j)
+                    if (sq[i][j])
+                        solver.force_row(toNode(n, i, j, sq[i][j]));
+            return solver;
+        }
+    }
+
+    /**
+     * Complete a partial Latin square.
+     *
+     * @param sq the partial square, with 0s for empty cells
+     * @return the first completion found, if one exists
+     */
+    inline std::optional<latin_square> complete_square(const latin_square &sq) {
+        if (!isConsistent(sq))
+            return std::nullopt;
+
+        const auto n = sq.size();
+        auto solver = details::latinSolverFor(sq);
+        const auto sol = solver.run();
+        if (!sol)
+            return std::nullopt;
+
+        latin_square result(n, std::vector<size_t>(n));
+        for (size_t row = 0; row < sol->size(); ++row)
+            if ((*sol)[row])
+                result[row / (n * n)][(row / n) % n] = row % n + 1;
+        return result;
+    }
+
+    /**
+     * Count the completions of a partial Latin square, stopping at limit.
+     *
+     * @param sq the partial square, with 0s for empty cells
+     * @param limit the number of solutions after which to stop searching
+     * @return the number of completions, capped at limit
+     */
+    inline size_t count_completions(const latin_square &sq, size_t limit = std::numeric_limits<size_t>::max()) {
+        if (!isConsistent(sq))
+            return 0;
+        return details::latinSolverFor(sq).count(limit);
+    }
+
+    /**
+     * Generate a random Latin square of order n with the Markov chain of Jacobson and Matthews, whose
+     * stationary distribution is uniform over the Latin squares of order n. The square is viewed as an
+     * incidence cube with an entry of 1 at (i, j, s) if cell (i, j) holds s, and each move changes a 2x2x2
+     * subcube, possibly passing through an improper cube with a single entry of -1.
+     *
+     * @param n the order of the square
+     * @param seed the seed
+     * @return the square
+     */
+    inline latin_square randomLatinSquare(size_t n, std::uint64_t seed) {
+        std::mt19937_64 gen{seed};
+        const auto uniform = [&gen](size_t bound) {
+            return std::uniform_int_distribution<size_t>{0, bound - 1}(gen);
+        };
+
+        // Start from the cyclic square.
+        std::vector<int> cube(n * n * n, 0);
+        const auto at = [&cube, n](size_t i, size_t j, size_t s) -> int & { return cube[(i * n + j) * n + s]; };
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                at(i, j, (i + j) % n) = 1;
+
+        // Pick one of the entries of 1 on a line of the cube at random: for a proper cube there is one, and for
+        // the line through the entry of -1 in an improper one, there are two.
+        const auto pickOne = [&uniform, n](const auto &value) {
+            std::vector<size_t> ones;
+            for (size_t x = 0; x < n; ++x)
+                if (value(x) == 1)
+                    ones.emplace_back(x);
+            return ones[uniform(ones.size())];
+        };
+
+        // The cube of order 1 has no entries of 0 to move from.
+        bool proper = true;
+        size_t i = 0, j = 0, s = 0;
+        for (size_t step = 0; n > 1 && (step < n * n * n || !proper); ++step) {
+            if (proper) {
+                // Choose an entry of 0 at random.
+                do {
+                    i = uniform(n);
+                    j = uniform(n);
+                    s = uniform(n);
+                } while (at(i, j, s));
+            }
+
+            const auto i2 = pickOne([&](size_t x) { return at(x, j, s); });
+            const auto j2 = pickOne([&](size_t x) { return at(i, x, s); });
+            const auto s2 = pickOne([&](size_t x) { return at(i, j, x); });
+
+            ++at(i, j, s);
+            ++at(i, j2, s2);
+            ++at(i2, j, s2);
+            ++at(i2, j2, s);
+            --at(i, j, s2);
+            --at(i, j2, s);
+            --at(i2, j, s);
+            --at(i2, j2, s2);
+
+            proper = at(i2, j2, s2) != -1;
+            if (!proper) {
+                i = i2;
+                j = j2;
+                s = s2;
+            }
+        }
+
+        latin_square sq(n, std::vector<size_t>(n));
+        for (size_t x = 0; x < n; ++x)
+            for (size_t y = 0; y < n; ++y)
+                for (size_t z = 0; z < n; ++z)
+                    if (at(x, y, z) == 1)
+                        sq[x][y] = z + 1;
+        return sq;
+    }
+
+    /**
+     * Punch holes in a square to make a quasigroup with holes problem, which always has a completion. The
+     * difficulty of completing it is governed by the fraction of holes: for large orders, there is a sharp peak
+     * near 42% of the cells.
+     *
+     * @param sq the square
+     * @param holes the fraction of the cells to empty, between 0 and 1
+     * @param seed the seed determining which cells are emptied
+     * @return the partial square
+     */
+    inline latin_square punchHoles(latin_square sq, double holes, std::uint64_t seed) {
+        const auto n = sq.size();
+        std::vector<size_t> cells(n * n);
+        for (size_t idx = 0; idx < cells.size(); ++idx)
+            cells[idx] = idx;
+        std::shuffle(cells.begin(), cells.end(), std::mt19937_64{seed});
+
+        const auto count = std::min(cells.size(), static_cast<size_t>(holes * cells.size() + 0.5));
+        for (size_t idx = 0; idx < count; ++idx)
+            sq[cells[idx] / n][cells[idx] % n] = 0;
+        return sq;
+    }
+
+    /// Display a partial Latin square to clog.
+    inline void print_square(const latin_square &sq) noexcept {
+        for (const auto &row: sq) {
+            for (const auto s: row)
+                std::clog << s << ' ';
+            std::clog << '\n';
+        }
+        std::flush(std::clog);
+    }
+}
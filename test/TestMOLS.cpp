@@ -0,0 +1,92 @@
+/**
+ * TestMOLS.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <array>
+#include <iostream>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestMOLS.h"
+#include "TestTiming.h"
+
+using namespace mols;
+
+namespace {
+    /// Determine if a set of Latin squares is mutually orthogonal.
+    bool areMutuallyOrthogonal(const std::vector<latin_square> &squares) {
+        for (size_t a = 0; a < squares.size(); ++a) {
+            if (!latin::isConsistent(squares[a]))
+                return false;
+            for (size_t b = a + 1; b < squares.size(); ++b)
+                if (!areOrthogonal(squares[a], squares[b]))
+                    return false;
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Transversals of cyclic Latin squares") {
+    // The cyclic squares of even order have no transversals.
+    const std::vector<size_t> expected{1, 0, 3, 0, 15, 0, 133, 0};
+    for (size_t n = 1; n <= expected.size(); ++n)
+        REQUIRE(transversals({cyclicSquare(n)}).size() == expected[n - 1]);
+    REQUIRE(!orthogonal_mate({cyclicSquare(6)}));
+}
+
+TEST_CASE("Orthogonal mates") {
+    const auto sq = cyclicSquare(7);
+    const auto mate = orthogonal_mate({sq});
+    REQUIRE(mate);
+    latin::print_square(*mate);
+    REQUIRE(areMutuallyOrthogonal({sq, *mate}));
+
+    const auto mates = orthogonal_mates({sq});
+    REQUIRE(!mates.empty());
+    for (const auto &m: mates)
+        REQUIRE(areOrthogonal(sq, m));
+    REQUIRE(count_orthogonal_mates({sq}, 2) == mates.size());
+}
+
+TEST_CASE("Complete sets of mutually orthogonal Latin squares") {
+    // The cyclic square of order 4 has no mate, but the table of Z_2 x Z_2 extends to a complete set.
+    REQUIRE(!find_mols({cyclicSquare(4)}, 2));
+    latin_square klein(4, std::vector<size_t>(4));
+    for (size_t i = 0; i < 4; ++i)
+        for (size_t j = 0; j < 4; ++j)
+            klein[i][j] = (i ^ j) + 1;
+    const auto four = find_mols({klein}, 3);
+    REQUIRE(four);
+    REQUIRE(areMutuallyOrthogonal(*four));
+
+    for (const size_t n: {5, 7}) {
+        const auto set = find_mols({cyclicSquare(n)}, n - 1);
+        REQUIRE(set);
+        REQUIRE(set->size() == n - 1);
+        REQUIRE(areMutuallyOrthogonal(*set));
+    }
+}
+
+TEST_CASE("Orthogonal mates of random Latin squares of order 10", "[.benchmark]") {
+    // A random Latin square need not have an orthogonal mate, so only the consistency of the results is checked.
+    std::array<bool, 5> hasMate{};
+    for (std::uint64_t seed = 0; seed < hasMate.size(); ++seed) {
+        const auto sq = latin::randomLatinSquare(10, seed);
+        const auto [mate, elapsed] = timing::timed([&] { return orthogonal_mate({sq}); });
+        std::clog << "seed " << seed << ": " << (mate ? "mate" : "no mate") << " in " << elapsed << "s" << std::endl;
+        hasMate[seed] = mate.has_value();
+        if (mate)
+            REQUIRE(areOrthogonal(sq, *mate));
+    }
+
+    // Counting all the mates explores the whole search tree, in parallel.
+    for (std::uint64_t seed = 0; seed < 2; ++seed) {
+        const auto sq = latin::randomLatinSquare(10, seed);
+        const auto [count, elapsed] = timing::timed([&] { return count_orthogonal_mates({sq}); });
+        std::clog << "seed " << seed << ": " << count << " mates in " << elapsed << "s" << std::endl;
+        REQUIRE((count > 0) == hasMate[seed]);
+    }
+}
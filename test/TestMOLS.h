@@ -0,0 +1,181 @@
+/**
+ * TestMOLS.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <dlx_contexpr.h>
+#include "TestLatinSquare.h"
+
+namespace mols {
+    using latin::latin_square;
+
+    /// A transversal of a Latin square of order n, where the cell in row i is (i, transversal[i]).
+    using transversal = std::vector<size_t>;
+
+    /// The Cayley table of the cyclic group of order n, with symbols 1 to n.
+    inline latin_square cyclicSquare(size_t n) {
+        latin_square sq(n, std::vector<size_t>(n));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+                sq[i][j] = (i + j) % n + 1;
+        return sq;
+    }
+
+    /**
+     * Determine if two Latin squares of the same order are orthogonal, i.e. if superimposing them gives every
+     * ordered pair of symbols exactly once.
+     */
+    inline bool areOrthogonal(const latin_square &a, const latin_square &b) {
+        const auto n = a.size();
+        std::vector<bool> seen(n * n, false);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                const auto idx = (a[i][j] - 1) * n + b[i][j] - 1;
+                if (seen[idx])
+                    return false;
+                seen[idx] = true;
+            }
+        return true;
+    }
+
+    /**
+     * Find the transversals common to a set of Latin squares of order n, i.e. the sets of n cells meeting every
+     * row and column once, on which each of the squares has every symbol once. The columns consist of:
+     * 1. n entries R_i, which represent that the transversal meets row i.
+     * 2. n entries C_j, which represent that the transversal meets column j.
+     * 3. n entries S_qs for each square q, which represent that the transversal contains symbol s of square q.
+     * The rows are the cells.
+     *
+     * @param squares the squares, which must be nonempty
+     * @return the common transversals
+     */
+    inline std::vector<transversal> transversals(const std::vector<latin_square> &squares) {
+        const auto n = squares.front().size();
+        dlx::position_vector positions;
+        positions.reserve((2 + squares.size()) * n * n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                const auto row = static_cast<int>(i * n + j);
+                positions.emplace_back(row, static_cast<int>(i));
+                positions.emplace_back(row, static_cast<int>(n + j));
+                for (size_t q = 0; q < squares.size(); ++q)
+                    positions.emplace_back(row, static_cast<int>((2 + q) * n + squares[q][i][j] - 1));
+            }
+
+        std::vector<transversal> result;
+        dlx::RuntimeDLX solver{(2 + squares.size()) * n, n * n, positions};
+        solver.for_each_solution([&result, n](const auto &sol) {
+            transversal t(n);
+            for (size_t cell = 0; cell < sol.size(); ++cell)
+                if (sol[cell])
+                    t[cell / n] = cell % n;
+            result.emplace_back(std::move(t));
+        });
+        return result;
+    }
+
+    namespace details {
+        /**
+         * The formulation of the orthogonal mates of a set of squares: the columns are the n^2 cells, which must
+         * each be covered once, and the rows are the common transversals.
+         */
+        inline dlx::RuntimeDLX mateSolver(size_t n, const std::vector<transversal> &ts) {
+            dlx::position_vector positions;
+            positions.reserve(n * ts.size());
+            for (size_t row = 0; row < ts.size(); ++row)
+                for (size_t i = 0; i < n; ++i)
+                    positions.emplace_back(static_cast<int>(row), static_cast<int>(i * n + ts[row][i]));
+            return dlx::RuntimeDLX{n * n, ts.size(), positions};
+        }
+
+        /**
+         * The square given by a decomposition of the cells into transversals, where the transversal through
+         * cell (0, j) holds symbol j + 1, so that the first row is 1, ..., n.
+         */
+        inline latin_square mateOf(size_t n, const std::vector<transversal> &ts, const dlx::RuntimeDLX::solution &sol) {
+            latin_square mate(n, std::vector<size_t>(n));
+            for (size_t row = 0; row < sol.size(); ++row)
+                if (sol[row])
+                    for (size_t i = 0; i < n; ++i)
+                        mate[i][ts[row][i]] = ts[row][0] + 1;
+            return mate;
+        }
+    }
+
+    /**
+     * Find a Latin square orthogonal to each of a set of mutually orthogonal Latin squares, by decomposing the
+     * cells into n disjoint common transversals: the symbol of a cell in the mate names its transversal.
+     *
+     * @param squares the squares, which must be nonempty
+     * @return a mate, with first row 1, ..., n, if there is one
+     */
+    inline std::optional<latin_square> orthogonal_mate(const std::vector<latin_square> &squares) {
+        const auto n = squares.front().size();
+        const auto ts = transversals(squares);
+        auto solver = details::mateSolver(n, ts);
+        const auto sol = solver.run();
+        if (!sol)
+            return std::nullopt;
+        return details::mateOf(n, ts, *sol);
+    }
+
+    /**
+     * Find the Latin squares orthogonal to each of a set of mutually orthogonal Latin squares, up to the
+     * relabeling of their symbols, as in orthogonal_mate.
+     *
+     * @param squares the squares, which must be nonempty
+     * @return the mates, with first rows 1, ..., n
+     */
+    inline std::vector<latin_square> orthogonal_mates(const std::vector<latin_square> &squares) {
+        const auto n = squares.front().size();
+        const auto ts = transversals(squares);
+        std::vector<latin_square> mates;
+        details::mateSolver(n, ts).for_each_solution([&](const auto &sol) {
+            mates.emplace_back(details::mateOf(n, ts, sol));
+        });
+        return mates;
+    }
+
+    /**
+     * Count the Latin squares orthogonal to each of a set of mutually orthogonal Latin squares, up to the
+     * relabeling of their symbols. The transversal decompositions are counted in parallel.
+     *
+     * @param squares the squares, which must be nonempty
+     * @param threads the number of threads to use
+     * @return the number of mates
+     */
+    inline size_t count_orthogonal_mates(const std::vector<latin_square> &squares,
+                                         size_t threads = std::thread::hardware_concurrency()) {
+        const auto n = squares.front().size();
+        return dlx::parallel_count(details::mateSolver(n, transversals(squares)), threads);
+    }
+
+    /**
+     * Extend a set of mutually orthogonal Latin squares to a set of k of them, by a depth-first search over the
+     * common orthogonal mates of the squares found so far.
+     *
+     * @param squares the squares, which must be nonempty and mutually orthogonal
+     * @param k the number of squares wanted
+     * @return the k squares, starting with the given ones, if they can be found
+     */
+    inline std::optional<std::vector<latin_square>> find_mols(const std::vector<latin_square> &squares, size_t k) {
+        if (squares.size() >= k)
+            return squares;
+
+        for (const auto &mate: orthogonal_mates(squares)) {
+            auto extended = squares;
+            extended.emplace_back(mate);
+            if (auto result = find_mols(extended, k))
+                return result;
+        }
+        return std::nullopt;
+    }
+}
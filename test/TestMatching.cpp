@@ -0,0 +1,92 @@
+/**
+ * TestMatching.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <iostream>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestMatching.h"
+#include "TestTiming.h"
+
+using namespace matching;
+
+TEST_CASE("Kasteleyn's formula") {
+    REQUIRE(kasteleyn(2, 2) == 2);
+    REQUIRE(kasteleyn(2, 10) == 89);
+    REQUIRE(kasteleyn(3, 3) == 0);
+    REQUIRE(kasteleyn(8, 8) == 12988816);
+}
+
+TEST_CASE("Count domino tilings of rectangles") {
+    // Visiting every tiling agrees with memoized counting where that is feasible.
+    for (size_t m = 1; m <= 4; ++m)
+        for (size_t n = m; n <= 6; ++n) {
+            REQUIRE(count_domino_tilings(rectangle(m, n), false) == kasteleyn(m, n));
+            REQUIRE(count_domino_tilings(rectangle(m, n)) == kasteleyn(m, n));
+        }
+
+    for (size_t m = 5; m <= 8; ++m)
+        for (size_t n = m; n <= 8; ++n)
+            REQUIRE(count_domino_tilings(rectangle(m, n)) == kasteleyn(m, n));
+}
+
+TEST_CASE("Count domino tilings of other regions") {
+    // The Aztec diamond of order n has 2^(n(n+1)/2) tilings.
+    for (size_t n = 1; n <= 6; ++n)
+        REQUIRE(count_domino_tilings(aztecDiamond(n)) == size_t{1} << (n * (n + 1) / 2));
+
+    // Removing opposite corners of a chessboard leaves no tilings, as they have the same colour.
+    const auto mutilated = parseRegion("#.......\n"
+                                       "........\n"
+                                       "........\n"
+                                       "........\n"
+                                       "........\n"
+                                       "........\n"
+                                       "........\n"
+                                       ".......#\n");
+    REQUIRE(count_domino_tilings(mutilated) == 0);
+
+    // Two 2x2 squares joined at a corner tile independently.
+    const auto bowtie = parseRegion("..##\n"
+                                    "..##\n"
+                                    "##..\n"
+                                    "##..\n");
+    REQUIRE(count_domino_tilings(bowtie) == 4);
+}
+
+TEST_CASE("Count perfect matchings of bipartite graphs") {
+    // The complete bipartite graph K_{n,n} has n! perfect matchings.
+    bipartite_graph complete{6, 6, {}};
+    for (size_t u = 0; u < 6; ++u)
+        for (size_t v = 0; v < 6; ++v)
+            complete.edges.emplace_back(u, v);
+    REQUIRE(count_perfect_matchings(complete) == 720);
+    REQUIRE(count_perfect_matchings(complete, false) == 720);
+
+    // The 2n-cycle has two.
+    bipartite_graph cycle{5, 5, {}};
+    for (size_t i = 0; i < 5; ++i) {
+        cycle.edges.emplace_back(i, i);
+        cycle.edges.emplace_back(i, (i + 1) % 5);
+    }
+    REQUIRE(count_perfect_matchings(cycle) == 2);
+
+    REQUIRE(count_perfect_matchings({2, 3, {{0, 0}, {1, 1}}}) == 0);
+}
+
+TEST_CASE("Count domino tilings of large regions", "[.benchmark]") {
+    for (const size_t n: {10, 12}) {
+        const auto [count, elapsed] = timing::timed([&] { return count_domino_tilings(rectangle(n, n)); });
+        std::clog << n << "x" << n << ": " << count << " tilings in " << elapsed << "s" << std::endl;
+        REQUIRE(count == kasteleyn(n, n));
+    }
+    for (const size_t n: {8, 10}) {
+        const auto [count, elapsed] = timing::timed([&] { return count_domino_tilings(aztecDiamond(n)); });
+        std::clog << "Aztec diamond " << n << ": " << count << " tilings in " << elapsed << "s" << std::endl;
+        REQUIRE(count == size_t{1} << (n * (n + 1) / 2));
+    }
+}
@@ -0,0 +1,168 @@
+/**
+ * TestMatching.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace matching {
+    /// A bipartite graph with vertices 0, ..., left - 1 on one side and 0, ..., right - 1 on the other.
+    struct bipartite_graph {
+        size_t left;
+        size_t right;
+        std::vector<std::pair<size_t, size_t>> edges;
+    };
+
+    /// A region of the square grid: the cells marked free are to be tiled.
+    using grid_region = std::vector<std::vector<bool>>;
+
+    /**
+     * Create a formulation of the perfect matchings of a bipartite graph. The columns consist of:
+     * 1. left entries A_u, which represent that vertex u on the left is matched.
+     * 2. right entries B_v, which represent that vertex v on the right is matched.
+     * The rows are the edges, in order, and have two nodes each.
+     *
+     * @param g the graph
+     * @return the position vector for the formulation
+     */
+    inline dlx::position_vector makeMatchingPositions(const bipartite_graph &g) {
+        dlx::position_vector positions;
+        positions.reserve(2 * g.edges.size());
+        for (size_t row = 0; row < g.edges.size(); ++row) {
+            const auto [u, v] = g.edges[row];
+            positions.emplace_back(static_cast<int>(row), static_cast<int>(u));
+            positions.emplace_back(static_cast<int>(row), static_cast<int>(g.left + v));
+        }
+        return positions;
+    }
+
+    /// A height by width rectangular region.
+    inline grid_region rectangle(size_t height, size_t width) {
+        return grid_region(height, std::vector<bool>(width, true));
+    }
+
+    /// A region parsed from rows separated by newlines, where '.' is free and any other character is not.
+    inline grid_region parseRegion(std::string_view rows) {
+        grid_region region{{}};
+        for (const auto ch: rows) {
+            if (ch == '\n')
+                region.emplace_back();
+            else
+                region.back().emplace_back(ch == '.');
+        }
+        if (region.back().empty())
+            region.pop_back();
+        return region;
+    }
+
+    /**
+     * The Aztec diamond of order n: the cells of the square grid whose centres (x, y) have |x| + |y| <= n.
+     *
+     * @param n the order
+     * @return the region
+     */
+    inline grid_region aztecDiamond(size_t n) {
+        grid_region region(2 * n, std::vector<bool>(2 * n, false));
+        for (size_t i = 0; i < 2 * n; ++i)
+            for (size_t j = 0; j < 2 * n; ++j) {
+                // Measure twice the distance from the centre to the centre of the cell.
+                const auto di = 2 * i + 1 > 2 * n ? 2 * i + 1 - 2 * n : 2 * n - 2 * i - 1;
+                const auto dj = 2 * j + 1 > 2 * n ? 2 * j + 1 - 2 * n : 2 * n - 2 * j - 1;
+                region[i][j] = di + dj <= 2 * n;
+            }
+        return region;
+    }
+
+    /**
+     * The bipartite graph of the domino tilings of a region: the cells are coloured as a chessboard, with the
+     * dark cells on the left and the light cells on the right, and a domino is an edge between adjacent cells.
+     *
+     * @param region the region
+     * @return the graph
+     */
+    inline bipartite_graph dominoGraph(const grid_region &region) {
+        const auto none = std::numeric_limits<size_t>::max();
+        std::vector<std::vector<size_t>> vertex(region.size());
+        bipartite_graph g{0, 0, {}};
+        for (size_t i = 0; i < region.size(); ++i) {
+            vertex[i].assign(region[i].size(), none);
+            for (size_t j = 0; j < region[i].size(); ++j)
+                if (region[i][j])
+                    vertex[i][j] = (i + j) % 2 == 0 ? g.left++ : g.right++;
+        }
+
+        const auto isFree = [&region](size_t i, size_t j) {
+            return i < region.size() && j < region[i].size() && region[i][j];
+        };
+        for (size_t i = 0; i < region.size(); ++i)
+            for (size_t j = 0; j < region[i].size(); ++j) {
+                if (!region[i][j] || (i + j) % 2)
+                    continue;
+                for (const auto &[ni, nj]: {std::pair{i + 1, j}, std::pair{i, j + 1},
+                                            std::pair{i - 1, j}, std::pair{i, j - 1}})
+                    if (isFree(ni, nj))
+                        g.edges.emplace_back(vertex[i][j], vertex[ni][nj]);
+            }
+        return g;
+    }
+
+    /**
+     * Count the perfect matchings of a bipartite graph.
+     *
+     * As the chosen edges split the graph into independent parts, which recur along different paths of the
+     * search, the count is memoized by default: the number of matchings is usually far too large to visit
+     * them one by one.
+     *
+     * @param g the graph
+     * @param memoized true if the count is to be memoized, and false if every matching is to be visited
+     * @return the number of perfect matchings
+     */
+    inline size_t count_perfect_matchings(const bipartite_graph &g, bool memoized = true) {
+        if (g.left != g.right)
+            return 0;
+        dlx::RuntimeDLX solver{g.left + g.right, g.edges.size(), makeMatchingPositions(g)};
+        return memoized ? solver.count_memoized() : solver.count();
+    }
+
+    /// Count the domino tilings of a region, as count_perfect_matchings does.
+    inline size_t count_domino_tilings(const grid_region &region, bool memoized = true) {
+        return count_perfect_matchings(dominoGraph(region), memoized);
+    }
+
+    /**
+     * Kasteleyn's formula for the number of domino tilings of an m by n rectangle:
+     * the product over 1 <= j <= ceil(m/2) and 1 <= k <= ceil(n/2) of 4 cos^2(pi j / (m+1)) + 4 cos^2(pi k / (n+1)).
+     * The product is computed in extended precision and rounded. This agrees with an exact count for all m, n <= 12,
+     * but not beyond: e.g. the 12 by 13 rectangle is off by 7.
+     *
+     * @param m the height of the rectangle
+     * @param n the width of the rectangle
+     * @return the number of tilings
+     */
+    inline size_t kasteleyn(size_t m, size_t n) {
+        assert(m <= 12 && n <= 12);
+        if ((m * n) % 2)
+            return 0;
+        const long double pi = std::acos(-1.0L);
+        long double product = 1;
+        for (size_t j = 1; j <= (m + 1) / 2; ++j)
+            for (size_t k = 1; k <= (n + 1) / 2; ++k) {
+                const auto cj = std::cos(pi * j / (m + 1));
+                const auto ck = std::cos(pi * k / (n + 1));
+                product *= 4 * cj * cj + 4 * ck * ck;
+            }
+        return static_cast<size_t>(std::llround(product));
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * TestNQueens.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <array>
+#include <iostream>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestNQueens.h"
+#include "TestTiming.h"
+
+using namespace nqueens;
+
+namespace {
+    /// The number of placements of n queens, for n = 0, ..., 16.
+    constexpr std::array<size_t, 17> knownCounts{{
+        1, 1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200, 73712, 365596, 2279184, 14772512
+    }};
+}
+
+TEST_CASE("Place 8 queens") {
+    constexpr auto solution = run_queens<8>();
+    REQUIRE(solution);
+    print_placement<8>(*solution);
+
+    for (size_t i = 0; i < 8; ++i)
+        for (size_t j = i + 1; j < 8; ++j) {
+            REQUIRE((*solution)[i] != (*solution)[j]);
+            REQUIRE((*solution)[i] + j != (*solution)[j] + i);
+            REQUIRE((*solution)[i] + i != (*solution)[j] + j);
+        }
+}
+
+TEST_CASE("No placement of 3 queens") {
+    constexpr auto solution = run_queens<3>();
+    REQUIRE(!solution);
+}
+
+TEST_CASE("Count n-queens placements") {
+    static_assert(count_queens<6>() == knownCounts[6]);
+    REQUIRE(count_queens<8>() == knownCounts[8]);
+
+    for (size_t n = 1; n <= 10; ++n)
+        REQUIRE(count_queens(n) == knownCounts[n]);
+}
+
+TEST_CASE("Count n-queens placements for n = 8, ..., 16", "[.benchmark]") {
+    for (size_t n = 8; n <= 16; ++n) {
+        const auto [count, elapsed] = timing::timed([&] { return count_queens(n); });
+        std::clog << n << "-queens: " << count << " placements in " << elapsed << "s" << std::endl;
+        REQUIRE(count == knownCounts[n]);
+    }
+}
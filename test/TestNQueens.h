@@ -0,0 +1,145 @@
+/**
+ * TestNQueens.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace nqueens {
+    /// The number of columns in the formulation of the n-queens problem: n ranks, n files, and 2 (2n - 1) diagonals.
+    constexpr size_t queensColumns(size_t n) noexcept {
+        return n == 0 ? 0 : 6 * n - 2;
+    }
+
+    /// The DLX instance used for the formulation of the n-queens problem.
+    template<size_t n>
+    using queens_dlx = dlx::DLX<queensColumns(n), n * n, 4 * n * n, 2 * n>;
+
+    /// A placement of n queens, where queen i is on rank i and file placement[i].
+    template<size_t n>
+    using placement = std::array<size_t, n>;
+
+    /**
+     * Create a formulation of the n-queens problem, i.e. place n queens on an n by n board so that no two of them
+     * attack each other. The columns consist of:
+     * 1. n primary columns R_i, which represent that a queen is on rank i.
+     * 2. n primary columns F_j, which represent that a queen is on file j.
+     * 3. 2n - 1 secondary columns A_d, which represent that a queen is on the diagonal i + j = d.
+     * 4. 2n - 1 secondary columns B_d, which represent that a queen is on the antidiagonal i - j + n - 1 = d.
+     * Every rank and file must have a queen, but a diagonal may be empty, so the diagonals are secondary.
+     *
+     * The rows are Q_ij, which represent that a queen is on square (i, j), and are numbered i * n + j.
+     *
+     * @tparam n the size of the board
+     * @return the position array for the formulation
+     */
+    template<size_t n>
+    constexpr dlx::position_array<4 * n * n> makeQueensPositions() noexcept {
+        using dlx_col_idx = int;
+        constexpr dlx_col_idx side = n;
+
+        int row = 0;
+        size_t node = 0;
+        dlx::position_array<4 * n * n> positions{};
+        const auto add = [&positions, &node, &row](dlx_col_idx column) {
+            // In order to mark this method constexpr, we need to assign to first and second individually.
+            positions[node].first = row;
+            positions[node].second = column;
+            ++node;
+        };
+
+        for (dlx_col_idx i = 0; i < side; ++i)
+            for (dlx_col_idx j = 0; j < side; ++j) {
+                add(i);
+                add(side + j);
+                add(2 * side + i + j);
+                add(4 * side - 1 + i - j + side - 1);
+                ++row;
+            }
+        return positions;
+    }
+
+    /**
+     * The formulation of makeQueensPositions for a board size chosen at run time.
+     *
+     * @param n the size of the board
+     * @return the position vector for the formulation
+     */
+    inline dlx::position_vector makeRuntimeQueensPositions(size_t n) {
+        dlx::position_vector positions;
+        positions.reserve(4 * n * n);
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                const auto row = static_cast<int>(i * n + j);
+                positions.emplace_back(row, static_cast<int>(i));
+                positions.emplace_back(row, static_cast<int>(n + j));
+                positions.emplace_back(row, static_cast<int>(2 * n + i + j));
+                positions.emplace_back(row, static_cast<int>(4 * n - 1 + i + n - 1 - j));
+            }
+        return positions;
+    }
+
+    /**
+     * Find a placement of n queens.
+     *
+     * @tparam n the size of the board
+     * @return a placement if one exists, and nullopt otherwise
+     */
+    template<size_t n>
+    constexpr std::optional<placement<n>> run_queens() noexcept {
+        const auto solution = queens_dlx<n>::run(makeQueensPositions<n>());
+        if (!solution)
+            return std::nullopt;
+
+        placement<n> p{};
+        for (size_t row = 0; row < n * n; ++row)
+            if ((*solution)[row])
+                p[row / n] = row % n;
+        return p;
+    }
+
+    /**
+     * Count the placements of n queens.
+     *
+     * @tparam n the size of the board
+     * @return the number of placements
+     */
+    template<size_t n>
+    constexpr size_t count_queens() noexcept {
+        return queens_dlx<n>::count(makeQueensPositions<n>());
+    }
+
+    /**
+     * Count the placements of n queens, for a board size chosen at run time. This is the entry point used to
+     * benchmark the engine, as it does not require a template instantiation per board size.
+     *
+     * @param n the size of the board
+     * @return the number of placements
+     */
+    inline size_t count_queens(size_t n) {
+        if (n == 0)
+            return 1;
+        dlx::RuntimeDLX solver{queensColumns(n), n * n, makeRuntimeQueensPositions(n), 2 * n};
+        return solver.count();
+    }
+
+    /// Display a placement to clog.
+    template<size_t n>
+    void print_placement(const placement<n> &p) noexcept {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j)
+                std::clog << (p[i] == j ? 'Q' : '.');
+            std::clog << '\n';
+        }
+        std::flush(std::clog);
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * TestPolyomino.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <map>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestPolyomino.h"
+
+using namespace polyomino;
+
+TEST_CASE("Orientations of the pentominoes") {
+    const std::map<char, size_t> expected{
+            {'F', 8}, {'I', 2}, {'L', 8}, {'N', 8}, {'P', 8}, {'T', 4},
+            {'U', 4}, {'V', 4}, {'W', 4}, {'X', 1}, {'Y', 8}, {'Z', 4}
+    };
+    for (const auto &p: pentominoes()) {
+        REQUIRE(p.cells.size() == 5);
+        REQUIRE(orientations(p.cells).size() == expected.at(p.name));
+    }
+
+    // Without reflection, the chiral pieces have half as many orientations.
+    REQUIRE(orientations(parseShape(".FF\nFF.\n.F."), false).size() == 4);
+    REQUIRE(orientations(parseShape("ZZ.\n.Z.\n.ZZ"), false).size() == 2);
+}
+
+TEST_CASE("Symmetries of boards") {
+    REQUIRE(boardSymmetries(rectangle(6, 10)).size() == 4);
+    REQUIRE(boardSymmetries(rectangle(8, 8)).size() == 8);
+    REQUIRE(boardSymmetries(rectangle(8, 8), false).size() == 4);
+    REQUIRE(boardSymmetries(parseBoard("...\n..#\n...")).size() == 2);
+}
+
+TEST_CASE("Pack pentominoes into a 3x20 rectangle") {
+    const auto grid = run_packing(pentominoes(), rectangle(3, 20));
+    REQUIRE(grid);
+    print_packing(*grid);
+
+    // There are two solutions up to symmetry, and each has four images.
+    REQUIRE(count_packings(pentominoes(), rectangle(3, 20)) == 2);
+    REQUIRE(count_packings(pentominoes(), rectangle(3, 20), true, false) == 8);
+}
+
+TEST_CASE("Pack tetrominoes") {
+    const std::vector<piece> tetrominoes{
+            {'I', parseShape("IIII")},
+            {'O', parseShape("OO\nOO")},
+            {'T', parseShape("TTT\n.T.")},
+            {'S', parseShape(".SS\nSS.")},
+            {'L', parseShape("L..\nLLL")}
+    };
+
+    // The five tetrominoes cannot tile a rectangle, by a checkerboard colouring argument.
+    REQUIRE(count_packings(tetrominoes, rectangle(4, 5)) == 0);
+    REQUIRE(!run_packing(tetrominoes, rectangle(2, 10)));
+
+    // Two L trominoes tile a 2x3 rectangle in two ways, which are images of each other.
+    const std::vector<piece> trominoes{{'A', parseShape("A.\nAA")}, {'B', parseShape("B.\nBB")}};
+    REQUIRE(count_packings(trominoes, rectangle(2, 3), true, false) == 4);
+}
+
+TEST_CASE("Pack pentominoes into a 6x10 rectangle", "[.benchmark]") {
+    REQUIRE(count_packings(pentominoes(), rectangle(6, 10)) == 2339);
+}
+
+TEST_CASE("Pack pentominoes into an 8x8 square with a 2x2 hole", "[.benchmark]") {
+    const auto board = parseBoard("........\n"
+                                  "........\n"
+                                  "........\n"
+                                  "...##...\n"
+                                  "...##...\n"
+                                  "........\n"
+                                  "........\n"
+                                  "........\n");
+    REQUIRE(count_packings(pentominoes(), board) == 65);
+}
+
+TEST_CASE("Rotations of polycubes") {
+    REQUIRE(boxSymmetries(box(3, 3, 3)).size() == 24);
+    REQUIRE(boxSymmetries(box(2, 3, 4)).size() == 4);
+    REQUIRE(boxSymmetries(box(2, 2, 5)).size() == 8);
+
+    const std::map<char, size_t> expected{{'V', 12}, {'L', 24}, {'T', 12}, {'Z', 12},
+                                          {'A', 12}, {'B', 12}, {'P', 8}};
+    for (const auto &p: somaPieces())
+        REQUIRE(orientations(p.cells).size() == expected.at(p.name));
+
+    // The screws are mirror images, so no rotation maps one onto the other.
+    const auto pieces = somaPieces();
+    const auto screws = orientations(pieces[4].cells);
+    REQUIRE(std::find(screws.cbegin(), screws.cend(), pieces[5].cells) == screws.cend());
+}
+
+TEST_CASE("Soma cube") {
+    const auto layers = run_packing(somaPieces(), box(3, 3, 3));
+    REQUIRE(layers);
+    for (const auto &layer: *layers) {
+        print_packing(layer);
+        std::clog << '\n';
+    }
+
+    // The 240 solutions up to rotation and reflection are 480 up to rotation, and 11520 in all.
+    REQUIRE(count_packings(somaPieces(), box(3, 3, 3)) == 480);
+    REQUIRE(count_packings(somaPieces(), box(3, 3, 3), false) == 11520);
+}
+
+TEST_CASE("Pack the pentominoes as pentacubes into boxes", "[.benchmark]") {
+    std::vector<polycube> pentacubes;
+    for (const auto &p: pentominoes()) {
+        solid s;
+        for (const auto &[r, c]: p.cells)
+            s.push_back({{r, c, 0}});
+        pentacubes.push_back({p.name, s});
+    }
+
+    // There are 12 and 3940 packings up to rotation and reflection. No packing is its own mirror image, and
+    // the pieces can be turned over, so there are twice as many up to rotation.
+    REQUIRE(count_packings(pentacubes, box(2, 3, 10)) == 24);
+    REQUIRE(count_packings(pentacubes, box(3, 4, 5)) == 7880);
+}
@@ -0,0 +1,664 @@
+/**
+ * TestPolyomino.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace polyomino {
+    /// A cell of a piece or board, as (row, column).
+    using cell = std::pair<int, int>;
+
+    /// The cells of a piece, normalized so that the minimum row and column are 0, and sorted.
+    using shape = std::vector<cell>;
+
+    /// A piece to pack, with the character used to display it.
+    struct piece {
+        char name;
+        shape cells;
+    };
+
+    /// The board to pack the pieces into: the cells marked free must be covered exactly once.
+    struct board_mask {
+        size_t height;
+        size_t width;
+        std::vector<bool> free;
+
+        bool isFree(int r, int c) const noexcept {
+            return 0 <= r && static_cast<size_t>(r) < height && 0 <= c && static_cast<size_t>(c) < width
+                   && free[r * width + c];
+        }
+    };
+
+    /// A symmetry of a board, as a permutation of its cells, indexed r * width + c.
+    using cell_permutation = std::vector<size_t>;
+
+    /// A placement of a piece on the board: the piece index and the board cells it covers, sorted.
+    struct placement {
+        size_t piece;
+        std::vector<size_t> cells;
+    };
+
+    /**
+     * The exact cover formulation of a packing problem. The columns consist of:
+     * 1. One primary column per piece, which represents that the piece is used.
+     * 2. One primary column per free cell of the board, which represents that the cell is covered.
+     * The rows are the placements, in the order of the placements vector.
+     */
+    struct packing {
+        size_t columns;
+        std::vector<placement> placements;
+        dlx::position_vector positions;
+    };
+
+    /**
+     * Translate a set of cells so that the minimum row and column are 0, and sort them, so that congruent
+     * shapes in the same orientation compare equal.
+     */
+    inline shape normalize(shape s) {
+        if (s.empty())
+            return s;
+        int minr = std::numeric_limits<int>::max();
+        int minc = std::numeric_limits<int>::max();
+        for (const auto &[r, c]: s) {
+            minr = std::min(minr, r);
+            minc = std::min(minc, c);
+        }
+        for (auto &[r, c]: s) {
+            r -= minr;
+            c -= minc;
+        }
+        std::sort(s.begin(), s.end());
+        return s;
+    }
+
+    /**
+     * Apply one of the eight symmetries of the square to a cell: 0 to 3 are the rotations by multiples of 90
+     * degrees, and 4 to 7 are the rotations followed by the reflection (r, c) -> (r, -c).
+     */
+    constexpr cell transform(size_t t, cell p) noexcept {
+        auto [r, c] = p;
+        for (size_t i = 0; i < t % 4; ++i) {
+            const auto tmp = r;
+            r = c;
+            c = -tmp;
+        }
+        if (t >= 4)
+            c = -c;
+        return {r, c};
+    }
+
+    /**
+     * Parse a shape or board from rows separated by newlines, where '.' and ' ' are empty and any other
+     * character is a cell.
+     */
+    inline shape parseShape(std::string_view rows) {
+        shape s;
+        int r = 0, c = 0;
+        for (const auto ch: rows) {
+            if (ch == '\n') {
+                ++r;
+                c = 0;
+                continue;
+            }
+            if (ch != '.' && ch != ' ')
+                s.emplace_back(r, c);
+            ++c;
+        }
+        return normalize(s);
+    }
+
+    /// A height by width rectangular board.
+    inline board_mask rectangle(size_t height, size_t width) {
+        return {height, width, std::vector<bool>(height * width, true)};
+    }
+
+    /// A board parsed from rows separated by newlines, where '.' is free and any other character is blocked.
+    inline board_mask parseBoard(std::string_view rows) {
+        std::vector<std::string> lines{""};
+        for (const auto ch: rows) {
+            if (ch == '\n')
+                lines.emplace_back();
+            else
+                lines.back() += ch;
+        }
+        if (lines.back().empty())
+            lines.pop_back();
+
+        size_t width = 0;
+        for (const auto &line: lines)
+            width = std::max(width, line.size());
+
+        board_mask b{lines.size(), width, std::vector<bool>(lines.size() * width, false)};
+        for (size_t r = 0; r < lines.size(); ++r)
+            for (size_t c = 0; c < lines[r].size(); ++c)
+                b.free[r * width + c] = lines[r][c] == '.';
+        return b;
+    }
+
+    /**
+     * The distinct orientations of a shape under rotation and, if allowed, reflection.
+     *
+     * @param s the shape
+     * @param reflections true if the piece may be flipped over
+     * @return the distinct orientations, the first being the normalized shape
+     */
+    inline std::vector<shape> orientations(const shape &s, bool reflections = true) {
+        std::vector<shape> result;
+        for (size_t t = 0; t < (reflections ? 8 : 4); ++t) {
+            shape image;
+            image.reserve(s.size());
+            for (const auto &p: s)
+                image.emplace_back(transform(t, p));
+            image = normalize(image);
+            if (std::find(result.cbegin(), result.cend(), image) == result.cend())
+                result.emplace_back(std::move(image));
+        }
+        return result;
+    }
+
+    /**
+     * The symmetries of the board among the eight symmetries of its bounding box (four if it is not square),
+     * as permutations of the free cells. The identity is first.
+     *
+     * @param b the board
+     * @param reflections true if the reflections of the board are to be included
+     * @return the symmetries
+     */
+    inline std::vector<cell_permutation> boardSymmetries(const board_mask &b, bool reflections = true) {
+        std::vector<cell_permutation> symmetries;
+        const int h = b.height;
+        const int w = b.width;
+        for (size_t t = 0; t < (reflections ? 8 : 4); ++t) {
+            // Find the translation that maps the transformed bounding box back onto the board.
+            const auto [r0, c0] = transform(t, {0, 0});
+            const auto [r1, c1] = transform(t, {h - 1, w - 1});
+            const auto dr = -std::min(r0, r1);
+            const auto dc = -std::min(c0, c1);
+
+            cell_permutation image(b.free.size(), std::numeric_limits<size_t>::max());
+            bool symmetric = true;
+            for (int r = 0; r < h && symmetric; ++r)
+                for (int c = 0; c < w && symmetric; ++c) {
+                    if (!b.isFree(r, c))
+                        continue;
+                    const auto [tr, tc] = transform(t, {r, c});
+                    if (!b.isFree(tr + dr, tc + dc))
+                        symmetric = false;
+                    else
+                        image[r * w + c] = (tr + dr) * w + tc + dc;
+                }
+            if (symmetric)
+                symmetries.emplace_back(std::move(image));
+        }
+        return symmetries;
+    }
+
+    namespace details {
+        /**
+         * Find a piece whose placements may be restricted to break the symmetries of the board: it must have no
+         * symmetries of its own, i.e. have as many orientations as there are symmetries of a cell, and be the
+         * only piece of its shape.
+         *
+         * @tparam Shape the type of the shapes of the pieces
+         * @param pieceOrientations the orientations of each piece
+         * @param full the number of orientations of a piece with no symmetries
+         * @return the index of the piece, if there is one
+         */
+        template<typename Shape>
+        std::optional<size_t> restrictablePiece(const std::vector<std::vector<Shape>> &pieceOrientations,
+                                                size_t full) {
+            for (size_t i = 0; i < pieceOrientations.size(); ++i) {
+                if (pieceOrientations[i].size() != full)
+                    continue;
+                const auto &first = pieceOrientations[i].front();
+                const auto copies = std::count_if(pieceOrientations.cbegin(), pieceOrientations.cend(),
+                        [&first](const auto &os) { return std::find(os.cbegin(), os.cend(), first) != os.cend(); });
+                if (copies == 1)
+                    return i;
+            }
+            return std::nullopt;
+        }
+
+        /// Determine if a set of cells is lexicographically least among its images under the symmetries.
+        inline bool isLeast(const std::vector<size_t> &cells, const std::vector<cell_permutation> &symmetries) {
+            std::vector<size_t> image(cells.size());
+            for (const auto &g: symmetries) {
+                for (size_t i = 0; i < cells.size(); ++i)
+                    image[i] = g[cells[i]];
+                std::sort(image.begin(), image.end());
+                if (image < cells)
+                    return false;
+            }
+            return true;
+        }
+
+        /**
+         * Create the formulation of a packing problem from the candidate placements of its pieces, dropping
+         * those of the restricted piece that are not least under the symmetries.
+         *
+         * @param numPieces the number of pieces
+         * @param free the cells that must be covered
+         * @param candidates the placements, with their cells sorted
+         * @param restricted the piece to restrict, if any
+         * @param symmetries the symmetries of the cells
+         * @return the formulation
+         */
+        inline packing makePacking(size_t numPieces, const std::vector<bool> &free,
+                                   std::vector<placement> &&candidates, std::optional<size_t> restricted,
+                                   const std::vector<cell_permutation> &symmetries) {
+            // The columns for the cells are numbered after those for the pieces.
+            std::vector<size_t> cellColumn(free.size(), std::numeric_limits<size_t>::max());
+            size_t columns = numPieces;
+            for (size_t idx = 0; idx < free.size(); ++idx)
+                if (free[idx])
+                    cellColumn[idx] = columns++;
+
+            packing result{columns, {}, {}};
+            for (auto &pl: candidates) {
+                if (restricted && *restricted == pl.piece && !isLeast(pl.cells, symmetries))
+                    continue;
+
+                const auto row = static_cast<int>(result.placements.size());
+                result.positions.emplace_back(row, static_cast<int>(pl.piece));
+                for (const auto idx: pl.cells)
+                    result.positions.emplace_back(row, static_cast<int>(cellColumn[idx]));
+                result.placements.emplace_back(std::move(pl));
+            }
+            return result;
+        }
+
+        /// Count the solutions of the formulation of a packing problem.
+        inline size_t countPackings(const packing &p) {
+            dlx::RuntimeDLX solver{p.columns, p.placements.size(), p.positions};
+            return solver.count();
+        }
+
+        /// Find a solution of the formulation of a packing problem, as the placements used.
+        inline std::optional<std::vector<placement>> runPacking(const packing &p) {
+            dlx::RuntimeDLX solver{p.columns, p.placements.size(), p.positions};
+            const auto sol = solver.run();
+            if (!sol)
+                return std::nullopt;
+
+            std::vector<placement> used;
+            for (size_t row = 0; row < sol->size(); ++row)
+                if ((*sol)[row])
+                    used.emplace_back(p.placements[row]);
+            return used;
+        }
+    }
+
+    /**
+     * Create the formulation of packing the pieces into the board.
+     *
+     * If breakSymmetry is set, a piece with no symmetries of its own that occurs only once is restricted to the
+     * placements that are lexicographically least among their images under the board symmetries. As the board
+     * symmetries act freely on its placements, exactly one solution of every class of equivalent solutions
+     * remains, and the number of solutions is divided by the order of the board symmetry group.
+     *
+     * @param pieces the pieces, each to be used exactly once
+     * @param b the board
+     * @param reflections true if the pieces may be flipped over
+     * @param breakSymmetry true if equivalent solutions under the board symmetries are to be pruned
+     * @return the formulation
+     */
+    inline packing makePacking(const std::vector<piece> &pieces, const board_mask &b,
+                               bool reflections = true, bool breakSymmetry = true) {
+        std::vector<std::vector<shape>> pieceOrientations;
+        pieceOrientations.reserve(pieces.size());
+        for (const auto &p: pieces)
+            pieceOrientations.emplace_back(orientations(normalize(p.cells), reflections));
+
+        const auto symmetries = breakSymmetry ? boardSymmetries(b, reflections) : std::vector<cell_permutation>{};
+        const auto restricted = symmetries.size() > 1 ?
+                details::restrictablePiece(pieceOrientations, reflections ? 8 : 4) : std::nullopt;
+
+        std::vector<placement> candidates;
+        for (size_t i = 0; i < pieces.size(); ++i)
+            for (const auto &o: pieceOrientations[i])
+                for (int r = 0; r < static_cast<int>(b.height); ++r)
+                    for (int c = 0; c < static_cast<int>(b.width); ++c) {
+                        placement pl{i, {}};
+                        for (const auto &[pr, pc]: o) {
+                            if (!b.isFree(r + pr, c + pc))
+                                break;
+                            pl.cells.emplace_back((r + pr) * b.width + c + pc);
+                        }
+                        if (pl.cells.size() != o.size())
+                            continue;
+                        std::sort(pl.cells.begin(), pl.cells.end());
+                        candidates.emplace_back(std::move(pl));
+                    }
+        return details::makePacking(pieces.size(), b.free, std::move(candidates), restricted, symmetries);
+    }
+
+    /**
+     * Count the packings of the pieces into the board.
+     *
+     * @param pieces the pieces, each to be used exactly once
+     * @param b the board
+     * @param reflections true if the pieces may be flipped over
+     * @param breakSymmetry true if only one of every class of solutions equivalent under the board symmetries is
+     *                      to be counted, which may not happen if no piece is suitable for restriction
+     * @return the number of packings
+     */
+    inline size_t count_packings(const std::vector<piece> &pieces, const board_mask &b,
+                                 bool reflections = true, bool breakSymmetry = true) {
+        return details::countPackings(makePacking(pieces, b, reflections, breakSymmetry));
+    }
+
+    /**
+     * Find a packing of the pieces into the board.
+     *
+     * @param pieces the pieces, each to be used exactly once
+     * @param b the board
+     * @param reflections true if the pieces may be flipped over
+     * @return the board rows, with the names of the pieces in the free cells, if a packing exists
+     */
+    inline std::optional<std::vector<std::string>> run_packing(const std::vector<piece> &pieces,
+                                                               const board_mask &b, bool reflections = true) {
+        const auto used = details::runPacking(makePacking(pieces, b, reflections));
+        if (!used)
+            return std::nullopt;
+
+        std::vector<std::string> grid(b.height, std::string(b.width, '#'));
+        for (const auto &pl: *used)
+            for (const auto idx: pl.cells)
+                grid[idx / b.width][idx % b.width] = pieces[pl.piece].name;
+        return grid;
+    }
+
+    /// The twelve pentominoes, named by Conway's letters.
+    inline std::vector<piece> pentominoes() {
+        return {
+                {'F', parseShape(".FF\nFF.\n.F.")},
+                {'I', parseShape("IIIII")},
+                {'L', parseShape("L...\nLLLL")},
+                {'N', parseShape("NN..\n.NNN")},
+                {'P', parseShape("PP\nPP\nP.")},
+                {'T', parseShape("TTT\n.T.\n.T.")},
+                {'U', parseShape("U.U\nUUU")},
+                {'V', parseShape("V..\nV..\nVVV")},
+                {'W', parseShape("W..\nWW.\n.WW")},
+                {'X', parseShape(".X.\nXXX\n.X.")},
+                {'Y', parseShape(".Y..\nYYYY")},
+                {'Z', parseShape("ZZ.\n.Z.\n.ZZ")}
+        };
+    }
+
+    /// Display a packing to clog.
+    inline void print_packing(const std::vector<std::string> &grid) noexcept {
+        for (const auto &row: grid)
+            std::clog << row << '\n';
+        std::flush(std::clog);
+    }
+
+    /**
+     * POLYCUBES
+     * The same packing problems in three dimensions, where the pieces may only be rotated.
+     **/
+
+    /// A voxel of a piece or box, as (x, y, z).
+    using voxel = std::array<int, 3>;
+
+    /// The voxels of a polycube, normalized so that the minimum coordinates are 0, and sorted.
+    using solid = std::vector<voxel>;
+
+    /// A polycube to pack, with the character used to display it.
+    struct polycube {
+        char name;
+        solid cells;
+    };
+
+    /// The box to pack the polycubes into: the voxels marked free must be covered exactly once.
+    struct voxel_mask {
+        std::array<size_t, 3> dims;
+        std::vector<bool> free;
+
+        size_t index(const voxel &v) const noexcept {
+            return (v[0] * dims[1] + v[1]) * dims[2] + v[2];
+        }
+
+        bool isFree(const voxel &v) const noexcept {
+            for (size_t i = 0; i < 3; ++i)
+                if (v[i] < 0 || static_cast<size_t>(v[i]) >= dims[i])
+                    return false;
+            return free[index(v)];
+        }
+    };
+
+    /// A rotation of space, mapping v to the vector with coordinates sign[i] * v[axis[i]].
+    struct rotation {
+        std::array<size_t, 3> axis;
+        std::array<int, 3> sign;
+
+        constexpr voxel operator()(const voxel &v) const noexcept {
+            return {sign[0] * v[axis[0]], sign[1] * v[axis[1]], sign[2] * v[axis[2]]};
+        }
+    };
+
+    /**
+     * The 24 rotations of the cube, i.e. the signed permutation matrices of determinant 1. The identity is first.
+     */
+    constexpr std::array<rotation, 24> rotations() noexcept {
+        constexpr std::array<std::array<size_t, 3>, 6> axes{{{0, 1, 2}, {1, 2, 0}, {2, 0, 1},
+                                                             {0, 2, 1}, {2, 1, 0}, {1, 0, 2}}};
+        std::array<rotation, 24> result{};
+        size_t idx = 0;
+        for (size_t a = 0; a < axes.size(); ++a) {
+            // The first three permutations are even, and the last three odd.
+            const int parity = a < 3 ? 1 : -1;
+            for (int signs = 0; signs < 8; ++signs) {
+                const std::array<int, 3> sign{{signs & 1 ? -1 : 1, signs & 2 ? -1 : 1, signs & 4 ? -1 : 1}};
+                if (sign[0] * sign[1] * sign[2] == parity) {
+                    result[idx].axis = axes[a];
+                    result[idx].sign = sign;
+                    ++idx;
+                }
+            }
+        }
+        return result;
+    }
+
+    /// Translate a set of voxels so that the minimum coordinates are 0, and sort them.
+    inline solid normalize(solid s) {
+        if (s.empty())
+            return s;
+        voxel minv{{std::numeric_limits<int>::max(), std::numeric_limits<int>::max(),
+                    std::numeric_limits<int>::max()}};
+        for (const auto &v: s)
+            for (size_t i = 0; i < 3; ++i)
+                minv[i] = std::min(minv[i], v[i]);
+        for (auto &v: s)
+            for (size_t i = 0; i < 3; ++i)
+                v[i] -= minv[i];
+        std::sort(s.begin(), s.end());
+        return s;
+    }
+
+    /**
+     * Parse a polycube from its layers, separated by '|', each of which has rows separated by newlines, where
+     * '.' and ' ' are empty and any other character is a voxel. Voxel (x, y, z) is in layer z, row x, column y.
+     */
+    inline solid parseSolid(std::string_view layers) {
+        solid s;
+        int x = 0, y = 0, z = 0;
+        for (const auto ch: layers) {
+            if (ch == '|') {
+                ++z;
+                x = y = 0;
+            } else if (ch == '\n') {
+                ++x;
+                y = 0;
+            } else {
+                if (ch != '.' && ch != ' ')
+                    s.push_back({{x, y, z}});
+                ++y;
+            }
+        }
+        return normalize(s);
+    }
+
+    /// An x by y by z box.
+    inline voxel_mask box(size_t x, size_t y, size_t z) {
+        return {{{x, y, z}}, std::vector<bool>(x * y * z, true)};
+    }
+
+    /// The distinct orientations of a polycube under rotation, the first being the normalized polycube.
+    inline std::vector<solid> orientations(const solid &s) {
+        std::vector<solid> result;
+        for (const auto &rot: rotations()) {
+            solid image;
+            image.reserve(s.size());
+            for (const auto &v: s)
+                image.emplace_back(rot(v));
+            image = normalize(image);
+            if (std::find(result.cbegin(), result.cend(), image) == result.cend())
+                result.emplace_back(std::move(image));
+        }
+        return result;
+    }
+
+    /**
+     * The rotations of the box that map its free voxels onto themselves, as permutations of the voxels, indexed
+     * by voxel_mask::index. The identity is first.
+     */
+    inline std::vector<cell_permutation> boxSymmetries(const voxel_mask &b) {
+        std::vector<cell_permutation> symmetries;
+        const voxel corner{{static_cast<int>(b.dims[0]) - 1, static_cast<int>(b.dims[1]) - 1,
+                            static_cast<int>(b.dims[2]) - 1}};
+        for (const auto &rot: rotations()) {
+            // Find the translation that maps the rotated box back onto the box.
+            const auto c0 = rot({{0, 0, 0}});
+            const auto c1 = rot(corner);
+            voxel shift{};
+            for (size_t i = 0; i < 3; ++i)
+                shift[i] = -std::min(c0[i], c1[i]);
+
+            cell_permutation image(b.free.size(), std::numeric_limits<size_t>::max());
+            bool symmetric = true;
+            for (int x = 0; x <= corner[0] && symmetric; ++x)
+                for (int y = 0; y <= corner[1] && symmetric; ++y)
+                    for (int z = 0; z <= corner[2] && symmetric; ++z) {
+                        const voxel v{{x, y, z}};
+                        if (!b.isFree(v))
+                            continue;
+                        auto w = rot(v);
+                        for (size_t i = 0; i < 3; ++i)
+                            w[i] += shift[i];
+                        if (!b.isFree(w))
+                            symmetric = false;
+                        else
+                            image[b.index(v)] = b.index(w);
+                    }
+            if (symmetric)
+                symmetries.emplace_back(std::move(image));
+        }
+        return symmetries;
+    }
+
+    /**
+     * Create the formulation of packing the polycubes into the box, as makePacking does for polyominoes, with
+     * the symmetries being the rotations of the box.
+     *
+     * @param pieces the polycubes, each to be used exactly once
+     * @param b the box
+     * @param breakSymmetry true if equivalent solutions under the rotations of the box are to be pruned
+     * @return the formulation, whose rows are the placements, with their cells numbered by voxel_mask::index
+     */
+    inline packing makePacking(const std::vector<polycube> &pieces, const voxel_mask &b, bool breakSymmetry = true) {
+        std::vector<std::vector<solid>> pieceOrientations;
+        pieceOrientations.reserve(pieces.size());
+        for (const auto &p: pieces)
+            pieceOrientations.emplace_back(orientations(normalize(p.cells)));
+
+        const auto symmetries = breakSymmetry ? boxSymmetries(b) : std::vector<cell_permutation>{};
+        const auto restricted = symmetries.size() > 1 ?
+                details::restrictablePiece(pieceOrientations, rotations().size()) : std::nullopt;
+
+        std::vector<placement> candidates;
+        for (size_t i = 0; i < pieces.size(); ++i)
+            for (const auto &o: pieceOrientations[i])
+                for (int x = 0; x < static_cast<int>(b.dims[0]); ++x)
+                    for (int y = 0; y < static_cast<int>(b.dims[1]); ++y)
+                        for (int z = 0; z < static_cast<int>(b.dims[2]); ++z) {
+                            placement pl{i, {}};
+                            for (const auto &v: o) {
+                                const voxel w{{x + v[0], y + v[1], z + v[2]}};
+                                if (!b.isFree(w))
+                                    break;
+                                pl.cells.emplace_back(b.index(w));
+                            }
+                            if (pl.cells.size() != o.size())
+                                continue;
+                            std::sort(pl.cells.begin(), pl.cells.end());
+                            candidates.emplace_back(std::move(pl));
+                        }
+        return details::makePacking(pieces.size(), b.free, std::move(candidates), restricted, symmetries);
+    }
+
+    /**
+     * Count the packings of the polycubes into the box.
+     *
+     * @param pieces the polycubes, each to be used exactly once
+     * @param b the box
+     * @param breakSymmetry true if only one of every class of solutions equivalent under the rotations of the box
+     *                      is to be counted, which may not happen if no polycube is suitable for restriction
+     * @return the number of packings
+     */
+    inline size_t count_packings(const std::vector<polycube> &pieces, const voxel_mask &b,
+                                 bool breakSymmetry = true) {
+        return details::countPackings(makePacking(pieces, b, breakSymmetry));
+    }
+
+    /**
+     * Find a packing of the polycubes into the box.
+     *
+     * @param pieces the polycubes, each to be used exactly once
+     * @param b the box
+     * @return the layers of the box by z, each with rows by x, with the names of the polycubes in the free
+     *         voxels, if a packing exists
+     */
+    inline std::optional<std::vector<std::vector<std::string>>> run_packing(const std::vector<polycube> &pieces,
+                                                                            const voxel_mask &b) {
+        const auto used = details::runPacking(makePacking(pieces, b));
+        if (!used)
+            return std::nullopt;
+
+        std::vector<std::vector<std::string>> layers(b.dims[2],
+                std::vector<std::string>(b.dims[0], std::string(b.dims[1], '#')));
+        for (const auto &pl: *used)
+            for (const auto idx: pl.cells)
+                layers[idx % b.dims[2]][idx / (b.dims[1] * b.dims[2])][(idx / b.dims[2]) % b.dims[1]] =
+                        pieces[pl.piece].name;
+        return layers;
+    }
+
+    /// The seven pieces of Piet Hein's Soma cube.
+    inline std::vector<polycube> somaPieces() {
+        return {
+                {'V', parseSolid("VV\nV.")},
+                {'L', parseSolid("LLL\nL..")},
+                {'T', parseSolid("TTT\n.T.")},
+                {'Z', parseSolid(".ZZ\nZZ.")},
+                {'A', parseSolid("AA\nA.|.A\n..")},
+                {'B', parseSolid("BB\nB.|..\nB.")},
+                {'P', parseSolid("PP\nP.|P.\n..")}
+        };
+    }
+}
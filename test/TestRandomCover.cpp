@@ -0,0 +1,128 @@
+/**
+ * TestRandomCover.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestRandomCover.h"
+#include "TestTiming.h"
+
+using namespace random_cover;
+
+TEST_CASE("Generating random exact cover instances") {
+    const parameters p{50, 200, uniformWidths(2, 5), true, 1};
+    const auto inst = generate(p);
+    REQUIRE(inst.rows() == 200);
+    REQUIRE(inst.offsets.front() == 0);
+    REQUIRE(inst.offsets.back() == inst.nodes());
+    for (size_t r = 0; r < inst.rows(); ++r) {
+        const auto first = inst.entries.cbegin() + inst.offsets[r];
+        const auto last = inst.entries.cbegin() + inst.offsets[r + 1];
+        REQUIRE(std::adjacent_find(first, last, std::greater_equal<>{}) == last);
+        REQUIRE(*(last - 1) < inst.columns);
+        if (std::find(inst.planted.cbegin(), inst.planted.cend(), r) == inst.planted.cend()) {
+            REQUIRE(last - first >= 2);
+            REQUIRE(last - first <= 5);
+        }
+    }
+
+    // The planted rows are an exact cover.
+    REQUIRE(dlx::verify_cover(inst.columns, toPositions(inst), plantedSolution(inst)));
+
+    // The same seed gives the same instance.
+    const auto again = generate(p);
+    REQUIRE(again.offsets == inst.offsets);
+    REQUIRE(again.entries == inst.entries);
+    REQUIRE(again.planted == inst.planted);
+}
+
+TEST_CASE("Feasible and infeasible random instances") {
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto feasible = generate({40, 120, uniformWidths(2, 4), true, seed});
+        auto solver = solverFor(feasible);
+        const auto sol = solver.run();
+        REQUIRE(sol);
+        REQUIRE(dlx::verify_cover(feasible.columns, toPositions(feasible), *sol));
+        REQUIRE(solver.count() >= 1);
+
+        const auto infeasible = generate({41, 120, uniformWidths(2, 4), false, seed});
+        REQUIRE(infeasible.planted.empty());
+        for (size_t r = 0; r < infeasible.rows(); ++r)
+            REQUIRE((infeasible.offsets[r + 1] - infeasible.offsets[r]) % 2 == 0);
+        REQUIRE(solverFor(infeasible).count() == 0);
+    }
+}
+
+TEST_CASE("Engines agree on random instances") {
+    // With rows of width 3 only, the number of nodes is known at compile time, so DLX can be used too.
+    constexpr size_t columns = 30;
+    constexpr size_t rows = 60;
+    for (std::uint64_t seed = 0; seed < 5; ++seed) {
+        const auto inst = generate({columns, rows, {0, 0, 0, 1}, true, seed});
+        REQUIRE(inst.rows() == rows);
+
+        const auto count = dlx::DLX<columns, rows, 3 * rows>::count(toPositionArray<3 * rows>(inst));
+        REQUIRE(count >= 1);
+        auto solver = solverFor(inst);
+        REQUIRE(solver.count() == count);
+        REQUIRE(solver.count_memoized() == count);
+        REQUIRE(dlx::parallel_count(solver, 4) == count);
+    }
+
+    // The number of nodes of an instance is checked against the one of the array.
+    const auto inst = generate({columns, rows, {0, 0, 0, 1}, true, 0});
+    REQUIRE_THROWS_AS(toPositionArray<3 * rows - 1>(inst), std::invalid_argument);
+}
+
+namespace {
+    /// Compare the stack arrays of DLX with the heap vectors of RuntimeDLX on an instance with rows of width 3.
+    template<size_t Columns, size_t Rows>
+    void compareLayouts(std::uint64_t seed) {
+        const auto inst = generate({Columns, Rows, {0, 0, 0, 1}, true, seed});
+        const auto positions = toPositionArray<3 * Rows>(inst);
+        auto solver = solverFor(inst);
+        const auto [count, array] = timing::timed([&] { return dlx::DLX<Columns, Rows, 3 * Rows>::count(positions); });
+        const auto [runtime, vector] = timing::timed([&] { return solver.count(); });
+        std::clog << Columns << " columns, " << Rows << " rows of width 3: " << count << " solutions; DLX "
+                  << array << "s, RuntimeDLX " << vector << "s" << std::endl;
+        REQUIRE(runtime == count);
+    }
+}
+
+TEST_CASE("Sweep random instances by size and density", "[.benchmark]") {
+    const auto threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (const size_t columns: {41, 61, 81})
+        for (const size_t density: {2, 3, 4})
+            for (const bool feasible: {true, false}) {
+                const auto inst = generate({columns - feasible, density * columns, uniformWidths(2, 6),
+                                            feasible, columns * density});
+                auto solver = solverFor(inst);
+                const auto [count, serial] = timing::timed([&] { return solver.count(); });
+                const auto [parallel, split] = timing::timed([&] { return dlx::parallel_count(solver, threads); });
+                std::clog << inst.columns << " columns, " << inst.rows() << " rows, "
+                          << (feasible ? "feasible" : "infeasible") << ": " << count << " solutions; count "
+                          << serial << "s, parallel_count " << split << "s";
+
+                // Random instances have no structure for memoization to find, so it only pays off when small.
+                if (columns <= 41) {
+                    const auto [memoized, memo] = timing::timed([&] { return solver.count_memoized(); });
+                    std::clog << ", count_memoized " << memo << "s";
+                    REQUIRE(memoized == count);
+                }
+                std::clog << std::endl;
+                REQUIRE(parallel == count);
+                REQUIRE((count > 0) == feasible);
+            }
+
+    compareLayouts<30, 90>(1);
+    compareLayouts<60, 180>(2);
+    compareLayouts<90, 270>(3);
+}
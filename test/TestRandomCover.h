@@ -0,0 +1,164 @@
+/**
+ * TestRandomCover.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace random_cover {
+    /**
+     * The parameters of a random exact cover instance. Rows are drawn with a random width, which is w with
+     * probability proportional to widths[w], and then a random set of columns of that width.
+     *
+     * If feasible is set, the columns are first partitioned into rows with widths drawn the same way, except
+     * for the last one, which takes the columns left over. This planted solution is then hidden among the other
+     * rows. Otherwise, only rows of even width are drawn, and the number of columns must be odd: the widths of
+     * the rows of an exact cover add up to the number of columns, so there can be none. This parity argument
+     * is invisible to DLX, which must search the whole tree to find that there is no solution.
+     */
+    struct parameters {
+        size_t columns;
+        size_t rows;
+        std::vector<double> widths;
+        bool feasible;
+        std::uint64_t seed;
+    };
+
+    /// The weights of the widths for rows of width uniform in [min, max].
+    inline std::vector<double> uniformWidths(size_t min, size_t max) {
+        std::vector<double> widths(max + 1, 0);
+        std::fill(widths.begin() + min, widths.end(), 1);
+        return widths;
+    }
+
+    /**
+     * An exact cover instance in compressed sparse row form: the columns of row r are entries[offsets[r]] to
+     * entries[offsets[r + 1] - 1], in increasing order. Listing them row by row gives positions sorted by row,
+     * as DLX and RuntimeDLX expect.
+     */
+    struct instance {
+        size_t columns;
+        std::vector<size_t> offsets;
+        std::vector<size_t> entries;
+
+        /// The rows of the planted solution, which are empty for an infeasible instance.
+        std::vector<size_t> planted;
+
+        size_t rows() const noexcept { return offsets.size() - 1; }
+        size_t nodes() const noexcept { return entries.size(); }
+    };
+
+    /**
+     * Generate a random exact cover instance.
+     *
+     * @param p the parameters, where p.rows includes the rows of the planted solution
+     * @return the instance, with rows in random order
+     */
+    inline instance generate(const parameters &p) {
+        assert(p.feasible || p.columns % 2 == 1);
+        std::mt19937_64 gen{p.seed};
+
+        auto weights = p.widths;
+        weights.resize(std::min(weights.size(), p.columns + 1));
+        if (!weights.empty())
+            weights[0] = 0;
+        if (!p.feasible)
+            for (size_t w = 1; w < weights.size(); w += 2)
+                weights[w] = 0;
+        assert(std::any_of(weights.cbegin(), weights.cend(), [](double weight) { return weight > 0; }));
+        std::discrete_distribution<size_t> width{weights.cbegin(), weights.cend()};
+
+        std::vector<size_t> all(p.columns);
+        std::iota(all.begin(), all.end(), 0);
+        std::vector<std::vector<size_t>> rows;
+
+        // Plant a solution by cutting a random permutation of the columns into rows.
+        if (p.feasible) {
+            std::shuffle(all.begin(), all.end(), gen);
+            for (size_t start = 0; start < p.columns;) {
+                const auto end = std::min(p.columns, start + std::max<size_t>(1, width(gen)));
+                rows.emplace_back(all.cbegin() + start, all.cbegin() + end);
+                start = end;
+            }
+        }
+        const auto plantedRows = rows.size();
+
+        // Draw the other rows by a partial Fisher-Yates shuffle of the columns.
+        while (rows.size() < std::max(p.rows, plantedRows)) {
+            const auto w = width(gen);
+            for (size_t k = 0; k < w; ++k)
+                std::swap(all[k], all[std::uniform_int_distribution<size_t>{k, p.columns - 1}(gen)]);
+            rows.emplace_back(all.cbegin(), all.cbegin() + w);
+        }
+
+        // Hide the planted rows among the others.
+        std::vector<size_t> order(rows.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), gen);
+
+        instance inst{p.columns, {0}, {}, {}};
+        for (size_t r = 0; r < order.size(); ++r) {
+            auto &row = rows[order[r]];
+            std::sort(row.begin(), row.end());
+            inst.entries.insert(inst.entries.end(), row.cbegin(), row.cend());
+            inst.offsets.emplace_back(inst.entries.size());
+            if (order[r] < plantedRows)
+                inst.planted.emplace_back(r);
+        }
+        return inst;
+    }
+
+    /// The positions of an instance, for RuntimeDLX.
+    inline dlx::position_vector toPositions(const instance &inst) {
+        dlx::position_vector positions;
+        positions.reserve(inst.nodes());
+        for (size_t r = 0; r < inst.rows(); ++r)
+            for (auto idx = inst.offsets[r]; idx < inst.offsets[r + 1]; ++idx)
+                positions.emplace_back(static_cast<int>(r), static_cast<int>(inst.entries[idx]));
+        return positions;
+    }
+
+    /**
+     * The positions of an instance, for DLX, which requires the number of nodes at compile time: e.g. an instance
+     * whose rows all have width k has k times as many nodes as rows.
+     *
+     * @tparam NumNodes the number of nodes of the instance
+     * @param inst the instance
+     * @return the positions
+     * @throws std::invalid_argument if the instance does not have exactly NumNodes nodes
+     */
+    template<size_t NumNodes>
+    dlx::position_array<NumNodes> toPositionArray(const instance &inst) {
+        if (inst.nodes() != NumNodes)
+            throw std::invalid_argument("the instance does not have the number of nodes of the position array");
+        const auto positions = toPositions(inst);
+        dlx::position_array<NumNodes> array{};
+        std::copy(positions.cbegin(), positions.cend(), array.begin());
+        return array;
+    }
+
+    /// The solver for an instance.
+    inline dlx::RuntimeDLX solverFor(const instance &inst) {
+        return dlx::RuntimeDLX{inst.columns, inst.rows(), toPositions(inst)};
+    }
+
+    /// The planted solution of an instance, as a solution of RuntimeDLX.
+    inline dlx::RuntimeDLX::solution plantedSolution(const instance &inst) {
+        dlx::RuntimeDLX::solution sol(inst.rows(), false);
+        for (const auto r: inst.planted)
+            sol[r] = true;
+        return sol;
+    }
+}
@@ -137,3 +137,126 @@ TEST_CASE("Small exact cover 4") {
     constexpr auto solution = dlx::DLX<10, 18, 35>::run(positions);
     REQUIRE(solution.has_value());
 }
+
+TEST_CASE("Small exact cover with secondary columns") {
+    // Over 2 primary columns and 1 secondary column:
+    //   0 1 2
+    // 0 1 0 1
+    // 1 0 1 1
+    // 2 1 0 0
+    // 3 0 1 0
+    constexpr dlx::position_array<6> positions {{
+        {0, 0}, {0, 2},
+        {1, 1}, {1, 2},
+        {2, 0},
+        {3, 1}
+    }};
+
+    // Rows 0 and 1 conflict in the secondary column, and it need not be covered.
+    constexpr auto secondary = dlx::DLX<3, 4, 6, 2>::count(positions);
+    REQUIRE(secondary == 3);
+
+    // If all columns are primary, column 2 must be covered.
+    constexpr auto primary = dlx::DLX<3, 4, 6>::count(positions);
+    REQUIRE(primary == 2);
+
+    constexpr auto solution = dlx::DLX<3, 4, 6, 2>::run(positions);
+    REQUIRE(solution.has_value());
+}
+
+TEST_CASE("Verifying exact covers") {
+    constexpr dlx::position_array<10> positions {
+            /** r0 **/ std::make_pair(0, 0), std::make_pair(0, 2), std::make_pair(0, 4),
+            /** r1 **/ std::make_pair(1, 0), std::make_pair(1, 1), std::make_pair(1, 3), std::make_pair(1, 5),
+            /** r2 **/ std::make_pair(2, 1), std::make_pair(2, 3),
+            /** r3 **/ std::make_pair(3, 5)
+    };
+    using Cover = dlx::DLX<6, 4, 10>;
+
+    constexpr auto solution = Cover::run(positions);
+    static_assert(Cover::verify(positions, *solution));
+
+    // Rows 0 and 1 both cover column 0, and rows 0 and 2 leave column 5 uncovered.
+    REQUIRE(!Cover::verify(positions, {{true, true, true, true}}));
+    REQUIRE(!Cover::verify(positions, {{true, false, true, false}}));
+
+    // Column 2 is secondary, so leaving it uncovered is fine, but covering it twice is not.
+    constexpr dlx::position_array<6> secondary {{
+        {0, 0}, {0, 2},
+        {1, 1}, {1, 2},
+        {2, 0},
+        {3, 1}
+    }};
+    REQUIRE(dlx::DLX<3, 4, 6, 2>::verify(secondary, {{false, false, true, true}}));
+    REQUIRE(!dlx::DLX<3, 4, 6, 2>::verify(secondary, {{true, true, false, false}}));
+    REQUIRE(!dlx::DLX<3, 4, 6>::verify(secondary, {{false, false, true, true}}));
+}
+
+TEST_CASE("Memoized counting of exact covers") {
+    // Over 2 primary columns and 1 secondary column, as above.
+    const dlx::position_vector positions {{
+        {0, 0}, {0, 2},
+        {1, 1}, {1, 2},
+        {2, 0},
+        {3, 1}
+    }};
+    dlx::RuntimeDLX secondary{3, 4, positions, 2};
+    REQUIRE(secondary.count_memoized() == 3);
+    dlx::RuntimeDLX primary{3, 4, positions};
+    REQUIRE(primary.count_memoized() == 2);
+
+    // Two independent copies of a problem with two solutions each, which are counted as a product.
+    const dlx::position_vector twice {{
+        {0, 0}, {0, 1},
+        {1, 0},
+        {2, 1},
+        {3, 2}, {3, 3},
+        {4, 2},
+        {5, 3}
+    }};
+    dlx::RuntimeDLX independent{4, 6, twice};
+    REQUIRE(independent.count_memoized() == 4);
+    REQUIRE(independent.count() == 4);
+
+    // Forced rows are respected.
+    independent.force_row(0);
+    REQUIRE(independent.count_memoized() == 2);
+}
+
+TEST_CASE("Small exact cover with colours") {
+    // Knuth's example of XCC: primary columns p, q, r, and secondary columns x, y with colours A = 1 and B = 2.
+    // The rows are p q x y; p r x:A y; p x:B; q x:A; r y:B.
+    const dlx::position_vector positions {{
+        {0, 0}, {0, 1}, {0, 3}, {0, 4},
+        {1, 0}, {1, 2}, {1, 3}, {1, 4},
+        {2, 0}, {2, 3},
+        {3, 1}, {3, 3},
+        {4, 2}, {4, 4}
+    }};
+    const dlx::colour_vector colours {{
+        0, 0, 0, 0,
+        0, 0, 1, 0,
+        0, 2,
+        0, 1,
+        0, 2
+    }};
+    dlx::RuntimeDLX dlx{5, 5, positions, 3, colours};
+    const auto sol = dlx.run();
+    REQUIRE(sol);
+    REQUIRE(*sol == std::vector<bool>{false, true, false, true, false});
+    REQUIRE(dlx::verify_cover(5, positions, *sol, 3, colours));
+    REQUIRE(dlx.count() == 1);
+
+    // Without the colours, x is covered by both rows of the solution.
+    REQUIRE(!dlx::verify_cover(5, positions, *sol, 3, {}));
+    REQUIRE(dlx::RuntimeDLX{5, 5, positions, 3}.count() == 0);
+
+    // Forcing a row purifies its columns as the search would.
+    dlx.force_row(10);
+    REQUIRE(dlx.count() == 1);
+    dlx.release_row(10);
+    dlx.force_row(8);
+    REQUIRE(dlx.count() == 0);
+    dlx.release_row(8);
+    REQUIRE(dlx.count() == 1);
+}
@@ -57,3 +57,351 @@ TEST_CASE("Solve minimal Sudoku") {
     REQUIRE(sol);
     print_solution<3>(*sol);
 }
+
+TEST_CASE("Uniqueness of Sudoku boards") {
+    constexpr auto minimal = parseBoard<3>("000801000000000043500000000000070800000000100020030000600000075003400000000200600");
+    REQUIRE(countClues<3>(minimal) == 17);
+    REQUIRE(isUnique<3>(minimal));
+
+    // Removing any clue from a 17-clue puzzle leaves more than one solution.
+    auto relaxed = minimal;
+    relaxed[0][3] = 0;
+    REQUIRE(!isUnique<3>(relaxed));
+    REQUIRE(countSolutions<3>(relaxed, 2) == 2);
+
+    // A contradictory board has no solutions.
+    auto contradiction = minimal;
+    contradiction[0][0] = 5;
+    REQUIRE(!isConsistent<3>(contradiction));
+    REQUIRE(countSolutions<3>(contradiction) == 0);
+}
+
+TEST_CASE("Generate minimal Sudoku puzzles") {
+    // The grid is only needed at run time, so the puzzle is not solved again in a constant expression.
+    const auto sol = runSudoku<21,3>("800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    REQUIRE(sol);
+    const auto grid = extractBoard<3>(*sol);
+
+    for (std::uint64_t seed = 0; seed < 3; ++seed) {
+        const auto puzzle = makeMinimalPuzzle<3>(grid, seed);
+        const auto clues = countClues<3>(puzzle);
+        REQUIRE(clues >= 17);
+        REQUIRE(clues <= 30);
+        REQUIRE(isUnique<3>(puzzle));
+
+        // Every clue is necessary, and the clues agree with the grid.
+        for (size_t i = 0; i < 9; ++i)
+            for (size_t j = 0; j < 9; ++j) {
+                if (!puzzle[i][j]) continue;
+                REQUIRE(puzzle[i][j] == grid[i][j]);
+                auto relaxed = puzzle;
+                relaxed[i][j] = 0;
+                REQUIRE(!isUnique<3>(relaxed));
+            }
+        print_board<3>(puzzle);
+    }
+}
+
+/// Check that a board is a complete, valid Sudoku grid that agrees with the clues of a puzzle.
+static bool solves(const board<3> &grid, const board<3> &puzzle) {
+    for (size_t i = 0; i < 9; ++i)
+        for (size_t j = 0; j < 9; ++j)
+            if (!grid[i][j] || (puzzle[i][j] && puzzle[i][j] != grid[i][j]))
+                return false;
+    return isConsistent<3>(grid);
+}
+
+TEST_CASE("Transforms of Sudoku boards") {
+    constexpr auto puzzle = parseBoard<3>("800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto t = randomTransform<3>(seed);
+        REQUIRE(applyInverseTransform<3>(applyTransform<3>(puzzle, t), t) == puzzle);
+    }
+}
+
+TEST_CASE("Canonical forms of equivalent Sudoku boards agree") {
+    constexpr auto puzzle = parseBoard<3>("000801000000000043500000000000070800000000100020030000600000075003400000000200600");
+    const auto [canonical, t] = canonicalForm<3>(puzzle);
+    REQUIRE(applyTransform<3>(puzzle, t) == canonical);
+    REQUIRE(countClues<3>(canonical) == 17);
+
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto disguised = applyTransform<3>(puzzle, randomTransform<3>(seed));
+        const auto [other, u] = canonicalForm<3>(disguised);
+        REQUIRE(other == canonical);
+        REQUIRE(applyTransform<3>(disguised, u) == canonical);
+    }
+
+    // A board that is not equivalent has a different canonical form.
+    auto relaxed = puzzle;
+    relaxed[0][3] = 0;
+    REQUIRE(canonicalForm<3>(relaxed).first != canonical);
+}
+
+TEST_CASE("Sudoku solution cache") {
+    constexpr auto puzzle = parseBoard<3>("800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    solution_cache<3> cache;
+
+    const auto sol = cache.solve(puzzle);
+    REQUIRE(sol);
+    REQUIRE(solves(*sol, puzzle));
+    REQUIRE(cache.misses() == 1);
+
+    REQUIRE(cache.solve(puzzle) == sol);
+    REQUIRE(cache.hits() == 1);
+
+    // Equivalent puzzles are answered from the cache, mapped back to their own labeling.
+    for (std::uint64_t seed = 0; seed < 10; ++seed) {
+        const auto disguised = applyTransform<3>(puzzle, randomTransform<3>(seed));
+        const auto other = cache.solve(disguised);
+        REQUIRE(other);
+        REQUIRE(solves(*other, disguised));
+    }
+    REQUIRE(cache.size() == 1);
+    REQUIRE(cache.misses() == 1);
+    REQUIRE(cache.hits() == 11);
+
+    // Unsolvable puzzles are cached as such.
+    auto contradiction = puzzle;
+    contradiction[0][1] = 8;
+    REQUIRE(!cache.solve(contradiction));
+    REQUIRE(cache.size() == 2);
+    REQUIRE(!cache.solve(applyTransform<3>(contradiction, randomTransform<3>(0))));
+    REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("Band classes of Sudoku") {
+    const auto small = bandClasses<2>();
+    size_t smallTotal = 0;
+    for (const auto &[b, size]: small)
+        smallTotal += size;
+    REQUIRE(smallTotal == 4);
+
+    const auto classes = bandClasses<3>();
+    size_t total = 0;
+    for (const auto &[b, size]: classes)
+        total += size;
+    REQUIRE(total == 2612736);
+    std::clog << classes.size() << " classes of the top band\n";
+}
+
+TEST_CASE("Count 4x4 Sudoku boards") {
+    REQUIRE(countToString(countGrids<2>()) == "288");
+    REQUIRE(countCompletions<2>(board<2>{}, 2) == 288);
+
+    const auto b = parseBoard<2>("1000000000000000");
+    REQUIRE(countCompletions<2>(b, 2) == 288 / 4);
+}
+
+TEST_CASE("Count completions of a Sudoku band by column triples") {
+    // The band whose rows are cyclic shifts by a box has 108374976 completions with the first column in order, as
+    // found by Felgenhauer and Jarvis, and permuting the rows of the lower bands and the bands gives 72 times that.
+    const band<3> b{{{1, 2, 3, 4, 5, 6, 7, 8, 9}, {4, 5, 6, 7, 8, 9, 1, 2, 3}, {7, 8, 9, 1, 2, 3, 4, 5, 6}}};
+    REQUIRE(details::countLowerBands<3>(b) == 72 * 108374976ull);
+}
+
+TEST_CASE("Count 9x9 Sudoku boards", "[.benchmark]") {
+    REQUIRE(countToString(countGrids<3>()) == "6670903752021072936960");
+}
+
+TEST_CASE("Count completions of a partial Sudoku") {
+    auto puzzle = parseBoard<3>("000801000000000043500000000000070800000000100020030000600000075003400000000200600");
+    puzzle[0][3] = 0;
+
+    const auto expected = countSolutions<3>(puzzle);
+    REQUIRE(expected == 64643);
+    REQUIRE(countCompletions<3>(puzzle, 4) == expected);
+}
+
+TEST_CASE("Sudoku variant formulations") {
+    // Each row starts at the node given by toRow.
+    constexpr auto positions = makeSudokuPositions<3, diagonals | hyper>();
+    for (size_t i = 0; i < 9; ++i)
+        for (size_t j = 0; j < 9; ++j)
+            for (size_t d = 1; d <= 9; ++d) {
+                const auto node = toRow<3, diagonals | hyper>({i, j, d});
+                REQUIRE(positions[node].first == static_cast<int>(81 * i + 9 * j + d - 1));
+                REQUIRE((node == 0 || positions[node - 1].first != positions[node].first));
+            }
+
+    REQUIRE(variantColumns<3, diagonals | hyper>() == 324 + 18 + 36);
+    REQUIRE(variantPrimaryColumns<3, secondary_diagonals>() == 324);
+    REQUIRE(variantNodes<3, secondary_diagonals>() == 2916 + 9 * 18);
+}
+
+TEST_CASE("Solve Sudoku variants") {
+    constexpr board<3> empty{};
+
+    const auto x = solveBoard<3, diagonals>(empty);
+    REQUIRE(x);
+    REQUIRE(countClues<3>(*x) == 81);
+    REQUIRE(isConsistent<3, diagonals>(*x));
+
+    const auto windoku = solveBoard<3, diagonals | hyper>(empty);
+    REQUIRE(windoku);
+    REQUIRE(countClues<3>(*windoku) == 81);
+    REQUIRE(isConsistent<3, diagonals | hyper>(*windoku));
+
+    // Blank the top band: the extra constraints can only remove completions.
+    auto puzzle = *windoku;
+    for (size_t i = 0; i < 3; ++i)
+        puzzle[i].fill(0);
+    const auto completions = countSolutions<3>(puzzle);
+    const auto xCompletions = countSolutions<3, diagonals>(puzzle);
+    const auto windokuCompletions = countSolutions<3, diagonals | hyper>(puzzle);
+    REQUIRE(windokuCompletions >= 1);
+    REQUIRE(windokuCompletions <= xCompletions);
+    REQUIRE(xCompletions <= completions);
+
+    // With secondary diagonals, the search does not branch on the diagonals, but the solutions are the same.
+    REQUIRE(countSolutions<3, secondary_diagonals>(puzzle) == xCompletions);
+    const auto secondary = solveBoard<3, secondary_diagonals>(puzzle);
+    REQUIRE(secondary);
+    REQUIRE(isConsistent<3, diagonals>(*secondary));
+}
+
+TEST_CASE("Solve jigsaw Sudoku") {
+    // The regions are derived from the grid at run time, so the puzzle is solved at run time too.
+    const auto sol = runSudoku<21,3>("800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    REQUIRE(sol);
+    const auto grid = extractBoard<3>(*sol);
+
+    // Exchange two cells with the same digit between the first two subgrids, so grid is still a solution.
+    auto regions = boxRegions<3>();
+    bool exchanged = false;
+    for (size_t p = 0; p < 9 && !exchanged; ++p)
+        for (size_t q = 0; q < 9 && !exchanged; ++q)
+            if (grid[p / 3][p % 3] == grid[3 + q / 3][q % 3]) {
+                std::swap(regions[p / 3][p % 3], regions[3 + q / 3][q % 3]);
+                exchanged = true;
+            }
+    REQUIRE(exchanged);
+    REQUIRE(isConsistent<3>(grid, regions));
+
+    const auto jigsaw = solveBoard<3>(board<3>{}, regions);
+    REQUIRE(jigsaw);
+    REQUIRE(countClues<3>(*jigsaw) == 81);
+    REQUIRE(isConsistent<3>(*jigsaw, regions));
+
+    // Blank a few rows of the grid: the completions respect the regions.
+    auto puzzle = grid;
+    for (size_t i = 0; i < 9; i += 2)
+        puzzle[i].fill(0);
+    const auto completion = solveBoard<3>(puzzle, regions);
+    REQUIRE(completion);
+    REQUIRE(isConsistent<3>(*completion, regions));
+    REQUIRE(countSolutions<3>(puzzle, 100, regions) >= 1);
+}
+
+TEST_CASE("Solve Sudoku of an order chosen at run time") {
+    // The solver for each order is built once and shared.
+    REQUIRE(&runtimeSolver(3) == &runtimeSolver(3));
+    REQUIRE(runtimeSolver(2).rows() == 64);
+
+    REQUIRE(countRuntimeSolutions(2, runtime_board(4, std::vector<size_t>(4))) == 288);
+
+    const auto puzzle = parseRuntimeBoard(3, "800000000003600000070090200050007000000045700000100030001000068008500010090000400");
+    REQUIRE(countRuntimeSolutions(3, puzzle) == 1);
+    const auto sol = solveRuntimeBoard(3, puzzle);
+    REQUIRE(sol);
+    REQUIRE(isConsistent(3, *sol));
+    const auto expected = extractBoard<3>(*runSudoku<21,3>("800000000003600000070090200050007000000045700000100030001000068008500010090000400"));
+    for (size_t i = 0; i < 9; ++i)
+        REQUIRE(std::equal(expected[i].cbegin(), expected[i].cend(), (*sol)[i].cbegin()));
+
+    // Inconsistent clues have no completions.
+    auto clash = puzzle;
+    clash[0][1] = 8;
+    REQUIRE(!solveRuntimeBoard(3, clash));
+    REQUIRE(countRuntimeSolutions(3, clash) == 0);
+
+    // Punch holes in the pattern grid of each larger order and solve it again.
+    for (const size_t N: {4, 5}) {
+        const auto side = N * N;
+        runtime_board b(side, std::vector<size_t>(side));
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                if ((7 * i + 3 * j) % 4)
+                    b[i][j] = ((i % N) * N + i / N + j) % side + 1;
+        REQUIRE(isConsistent(N, b));
+
+        const auto completion = solveRuntimeBoard(N, b);
+        REQUIRE(completion);
+        REQUIRE(isConsistent(N, *completion));
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j) {
+                REQUIRE((*completion)[i][j] != 0);
+                if (b[i][j])
+                    REQUIRE((*completion)[i][j] == b[i][j]);
+            }
+        REQUIRE(countRuntimeSolutions(N, b, 2) >= 1);
+    }
+
+    // The boards above are solved by naked and hidden singles alone. Of the 325 empty cells of this 25x25 board,
+    // the singles fill only 76, so the rest must be found by search.
+    const auto hard = parseRuntimeBoard(5,
+            "006HJC0I210OFAB000K030057"
+            "BE40398065210000NH07I00O0"
+            "000000JB0700N00200E0600A0"
+            "0000D00FGN3000800000000P0"
+            "10020KP0000DJM03600I4000L"
+            "CILB000070P6O0H0081DMF000"
+            "0301000O0FBL04A70050J0000"
+            "0F0G006900070004CANBD0000"
+            "09MDE020A000100O00LJ04BK0"
+            "00P600083DCM000I000G0000E"
+            "000901000H0050N0O0GL000M0"
+            "EHALB0030M00000900J0C0004"
+            "300FMD0L9800B00K00001000H"
+            "00800B00I0A940CN000PL2500"
+            "2N0J000K00LH080FI06E00A00"
+            "08B50A0000K000EG000F0009N"
+            "000C0JM1000B00904EPNKA200"
+            "JP0E9G0500N0000020M00040O"
+            "A2000N0P0O807JM01090GH000"
+            "GK00N074000200PL500AEC000"
+            "00G0001N80HFAB400509O0LIM"
+            "FL0I2E005B00090J704HN1P0D"
+            "06E00FG0LI0JPC0100O0A0740"
+            "M0004P970J00003CLI0608000"
+            "0008K0HCD010I70A003200JE0");
+    REQUIRE(countRuntimeSolutions(5, hard, 2) == 1);
+    const auto completion = solveRuntimeBoard(5, hard);
+    REQUIRE(completion);
+    REQUIRE(isConsistent(5, *completion));
+    for (size_t i = 0; i < 25; ++i)
+        for (size_t j = 0; j < 25; ++j) {
+            REQUIRE((*completion)[i][j] != 0);
+            if (hard[i][j])
+                REQUIRE((*completion)[i][j] == hard[i][j]);
+        }
+}
+
+TEST_CASE("Count Sudoku boards with symmetry pruning") {
+    auto solver = runtimeSolver(2);
+    REQUIRE(solver.count_with_symmetry(2) == 288);
+
+    // Fixing a clue leaves fewer symmetries, but the count is still exact.
+    solver.force_row(toRow<2>({0, 0, 1}));
+    REQUIRE(solver.count_with_symmetry(2) == 72);
+}
+
+TEST_CASE("Count Sudoku boards with relabeling symmetries") {
+    // The rows of the 4x4 formulation are the digits d in cells (i, j), numbered 16 i + 4 j + d - 1.
+    const auto relabel = [](const std::array<size_t, 4> &sigma) {
+        dlx::row_permutation rows(64);
+        for (size_t r = 0; r < 64; ++r)
+            rows[r] = r / 4 * 4 + sigma[r % 4];
+        return rows;
+    };
+    dlx::row_permutation transpose(64);
+    for (size_t r = 0; r < 64; ++r)
+        transpose[r] = (r / 4 % 4) * 16 + (r / 16) * 4 + r % 4;
+
+    auto solver = runtimeSolver(2);
+    solver.set_row_symmetries({relabel({1, 0, 2, 3}), relabel({1, 2, 3, 0}), transpose});
+    REQUIRE(solver.count() == 288);
+    const auto sol = solver.run();
+    REQUIRE(sol);
+    REQUIRE(std::count(sol->cbegin(), sol->cend(), true) == 16);
+}
@@ -6,11 +6,22 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <dlx_contexpr.h>
 
@@ -34,29 +45,157 @@ namespace sudoku {
     template<size_t N=3>
     using board = std::array<std::array<size_t, N * N>, N * N>;
 
+    /// Opt-in families of constraints for Sudoku variants, which may be combined with |.
+    enum variant : unsigned {
+        /// The standard constraints: rows, columns, subgrids (or jigsaw regions), and cell occupancy.
+        standard = 0,
+
+        /// X-Sudoku: every digit appears exactly once on each of the two main diagonals.
+        diagonals = 1u << 0u,
+
+        /// X-Sudoku with the diagonal constraints as secondary columns, i.e. every digit appears at most once on
+        /// each main diagonal. As a diagonal has N^2 cells, the solutions are the same as with diagonals, but the
+        /// search never branches on a diagonal.
+        secondary_diagonals = 1u << 1u,
+
+        /// Hyper Sudoku / Windoku: (N-1)^2 extra N by N regions, separated from each other and the edges of the
+        /// board by single lines, in which every digit appears exactly once.
+        hyper = 1u << 2u
+    };
+
+    /**
+     * A map assigning every cell to one of N^2 regions of N^2 cells, in which every digit appears exactly once.
+     * Normally, these are the subgrids, but for jigsaw Sudoku, any regions may be given.
+     */
+    template<size_t N=3>
+    using region_map = board<N>;
+
+    /**
+     * The region map of the standard Sudoku, where the regions are the subgrids, numbered in row-major order.
+     * @tparam N the size parameter of the Sudoku
+     * @return the region map
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    constexpr region_map<N> boxRegions() noexcept {
+        region_map<N> regions{};
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                regions[i][j] = (i / N) * N + j / N;
+        return regions;
+    }
+
+    /**
+     * Determine which of the hyper regions contains a cell. The regions begin at rows and columns
+     * 1, N + 2, 2N + 3, ..., 1 + (N - 2)(N + 1).
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param i the row of the cell
+     * @param j the column of the cell
+     * @return the index of the hyper region containing (i, j), or (N-1)^2 if there is none
+     */
+    template<size_t N = 3>
+    constexpr size_t hyperRegion(size_t i, size_t j) noexcept {
+        if (i % (N + 1) == 0 || j % (N + 1) == 0 || i / (N + 1) >= N - 1 || j / (N + 1) >= N - 1)
+            return (N - 1) * (N - 1);
+        return (i / (N + 1)) * (N - 1) + j / (N + 1);
+    }
+
+    /**
+     * The number of constraints satisfied by placing a digit in a cell, and thus the number of nodes in each of
+     * the DLX rows for the cell.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
+     * @param i the row of the cell
+     * @param j the column of the cell
+     * @return the number of constraints for cell (i, j)
+     */
+    template<size_t N = 3,
+            unsigned Variants = standard>
+    constexpr size_t cellConstraints(size_t i, size_t j) noexcept {
+        static_assert(!((Variants & diagonals) && (Variants & secondary_diagonals)),
+                "The diagonals are either primary or secondary");
+
+        size_t count = 4;
+        if (Variants & (diagonals | secondary_diagonals)) {
+            if (i == j) ++count;
+            if (i + j == N * N - 1) ++count;
+        }
+        if ((Variants & hyper) && hyperRegion<N>(i, j) < (N - 1) * (N - 1))
+            ++count;
+        return count;
+    }
+
+    /// The number of nodes in the formulation of a Sudoku variant.
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    constexpr size_t variantNodes() noexcept {
+        size_t nodes = 0;
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                nodes += cellConstraints<N, Variants>(i, j) * side;
+        return nodes;
+    }
+
+    /// The number of columns in the formulation of a Sudoku variant.
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    constexpr size_t variantColumns() noexcept {
+        size_t columns = 4 * side * side;
+        if (Variants & (diagonals | secondary_diagonals))
+            columns += 2 * side;
+        if (Variants & hyper)
+            columns += (N - 1) * (N - 1) * side;
+        return columns;
+    }
+
+    /// The number of primary columns in the formulation of a Sudoku variant, which precede the secondary ones.
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    constexpr size_t variantPrimaryColumns() noexcept {
+        return variantColumns<N, Variants>() - ((Variants & secondary_diagonals) ? 2 * side : 0);
+    }
+
+    /// The DLX instance used for the formulation of a Sudoku variant of size parameter N.
+    template<size_t N = 3,
+            unsigned Variants = standard>
+    using sudoku_dlx = dlx::DLX<variantColumns<N, Variants>(), N * N * N * N * N * N,
+            variantNodes<N, Variants>(), variantPrimaryColumns<N, Variants>()>;
+
     /**
      * Create a formulation of a generic (N^2 by N^2) Sudoku board with entries from 1 to N^2.
      * In the case of the standard Sudoku board, N = 3.
      * The columns consist of:
      * 1. N^4 entries R_in, which represent that in row i, entry n appears.
      * 2. N^4 entries C_jn, which represent that in column j, entry n appears.
-     * 3. N^4 enties G_xyn, which represent that in subgrid (x,y),  entry n appears.
+     * 3. N^4 enties G_rn, which represent that in region r,  entry n appears. The regions are the subgrids
+     *    unless a region map is given for jigsaw Sudoku.
      * 4. N^4 entries O_ij, which represent that in the board, cell (i,j) is occupied.
      *    (Without these constraints, you could have the algorithm allow multiple entries per cell.)
+     * 5. If requested by Variants, 2 N^2 entries D_dn, which represent that on diagonal d, entry n appears.
+     * 6. If requested by Variants, (N-1)^2 N^2 entries H_hn, which represent that in hyper region h, entry n
+     *    appears.
+     * 7. If requested by Variants, the diagonal entries of 5 as secondary columns.
      *
      * We have N^6 rows in the DLX problem, say R_ijn which represent the digit n appearing in
-     * cell (i,j) of the board. Each row has exactly four entries (one for each of the four
-     * classes appearing above.
+     * cell (i,j) of the board. Each row has an entry for each of the classes above that applies to
+     * the cell, i.e. four in the standard Sudoku. The extra classes thus constrain the search directly.
      */
     template<size_t N = 3,
+            unsigned Variants = standard,
             auto rows = N * N,
             auto cols = N * N,
             auto digits = N * N,
-            auto nodes = 4 * rows * cols * digits>
-    constexpr dlx::position_array<nodes> makeSudokuPositions() noexcept {
+            auto nodes = variantNodes<N, Variants>()>
+    constexpr dlx::position_array<nodes> makeSudokuPositions(const region_map<N> &regions = boxRegions<N>()) noexcept {
         using dlx_col_idx = int;
+        constexpr bool hasDiagonals = Variants & (diagonals | secondary_diagonals);
 
-        // Determine the starting position for each of the four category classes above.
+        // Determine the starting position for each of the category classes above.
         dlx_col_idx offset = 0;
 
         // 1. Rows
@@ -73,40 +212,60 @@ namespace sudoku {
                 colIndices[j][n] = j * cols + n + offset;
         offset += cols * digits;
 
-        // 3. Grids. We could work out a formula here but it's just easier to increment since
-        // the array has five dimensions.
-        int position = 0;
-        std::array<std::array<std::array<dlx_col_idx, digits>, N>, N> gridIndices{};
-        for (dlx_col_idx x = 0; x < N; ++x)
-            for (dlx_col_idx y = 0; y < N; ++y)
-                for (dlx_col_idx n = 0; n < digits; ++n)
-                    gridIndices[x][y][n] = position++ + offset;
-        offset += position;
+        // 3. Regions, which for the subgrids numbers them in row-major order.
+        std::array<std::array<dlx_col_idx, digits>, rows> regionIndices{};
+        for (dlx_col_idx r = 0; r < rows; ++r)
+            for (dlx_col_idx n = 0; n < digits; ++n)
+                regionIndices[r][n] = r * digits + n + offset;
+        offset += rows * digits;
 
         // 4. Cell occupancy.
         std::array<std::array<dlx_col_idx, cols>, rows> occupancy{};
         for (dlx_col_idx i = 0; i < rows; ++i)
             for (dlx_col_idx j = 0; j < cols; ++j)
                 occupancy[i][j] = i * rows + j + offset;
+        offset += rows * cols;
+
+        // 5. and 6. The primary variant constraints, and 7. the secondary diagonals at the end.
+        dlx_col_idx diagonalOffset = offset;
+        if (Variants & diagonals)
+            offset += 2 * digits;
+        const dlx_col_idx hyperOffset = offset;
+        if (Variants & hyper)
+            offset += (N - 1) * (N - 1) * digits;
+        if (Variants & secondary_diagonals)
+            diagonalOffset = offset;
 
         // Now we populate the position array, by creating N^6 rows trying every digit in
         // every row and every column.
         int row = 0;
+        size_t node = 0;
         dlx::position_array<nodes> array{};
+        const auto add = [&array, &node, &row](dlx_col_idx column) {
+            // In order to mark this method constexpr, we need to assign to first and second individually.
+            array[node].first = row;
+            array[node].second = column;
+            ++node;
+        };
+
         for (dlx_col_idx i = 0; i < rows; ++i)
             for (dlx_col_idx j = 0; j < cols; ++j)
                 for (dlx_col_idx n = 0; n < digits; ++n) {
-                    // This represents cell (i,j) holding digit n, so create four entries.
-                    array[4 * row + 0].first = row;
-                    array[4 * row + 1].first = row;
-                    array[4 * row + 2].first = row;
-                    array[4 * row + 3].first = row;
-
-                    // Now  find the columns for each, which correspond to the four cases above.
-                    array[4 * row + 0].second = rowIndices[i][n];
-                    array[4 * row + 1].second = colIndices[j][n];
-                    array[4 * row + 2].second = gridIndices[i / N][j / N][n];
-                    array[4 * row + 3].second = occupancy[i][j];
+                    // This represents cell (i,j) holding digit n, so create an entry for each class.
+                    add(rowIndices[i][n]);
+                    add(colIndices[j][n]);
+                    add(regionIndices[regions[i][j]][n]);
+                    add(occupancy[i][j]);
+
+                    if (hasDiagonals && i == j)
+                        add(diagonalOffset + n);
+                    if (hasDiagonals && i + j == rows - 1)
+                        add(diagonalOffset + digits + n);
+                    if (Variants & hyper) {
+                        const auto h = hyperRegion<N>(i, j);
+                        if (h < (N - 1) * (N - 1))
+                            add(hyperOffset + h * digits + n);
+                    }
 
                     ++row;
                 }
@@ -119,20 +278,30 @@ namespace sudoku {
      * row i, column j, this transforms it into a form usable by DLX.
      *
      * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
      * @param assignment the fixing
      * @return an index usable by DLX
      */
     template<size_t N = 3,
+            unsigned Variants = standard,
             const auto cols = N * N,
             const auto digits = N * N>
     constexpr size_t toRow(const fixing &assignment) noexcept {
         const auto [row, col, digit] = assignment;
 
-        // For each row, there are col * digit entries.
-        // For each col, there are digit entries.
-        // Thus, assignment is essentially a number written base N^2 that we convert to decimal.
-        // We want a node index in the row, however, so multiply by 4.
-        return 4 * (row * cols * digits + col * digits + digit - 1);
+        if constexpr (Variants == standard) {
+            // For each row, there are col * digit entries.
+            // For each col, there are digit entries.
+            // Thus, assignment is essentially a number written base N^2 that we convert to decimal.
+            // We want a node index in the row, however, so multiply by 4.
+            return 4 * (row * cols * digits + col * digits + digit - 1);
+        } else {
+            // The rows have different lengths, so sum the lengths of the rows of the preceding cells.
+            size_t node = 0;
+            for (size_t cell = 0; cell < row * cols + col; ++cell)
+                node += cellConstraints<N, Variants>(cell / cols, cell % cols) * digits;
+            return node + cellConstraints<N, Variants>(row, col) * (digit - 1);
+        }
     }
 
     /**
@@ -140,14 +309,15 @@ namespace sudoku {
      *
      * @tparam NumFixedRows the number of fixings in fixed: these should all have unique row and column
      * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
      * @param fixed the fixing array
      * @return an array usable by DLX
      */
-    template<size_t NumFixedRows, size_t N = 3>
+    template<size_t NumFixedRows, size_t N = 3, unsigned Variants = standard>
     constexpr std::array<size_t, NumFixedRows> makeFixedCells(const fixing_array <NumFixedRows> &fixed) noexcept {
         std::array<size_t, NumFixedRows> rows{};
         for (size_t i = 0; i < NumFixedRows; ++i)
-            rows[i] = toRow<N>(fixed[i]);
+            rows[i] = toRow<N, Variants>(fixed[i]);
         return std::move(rows);
     }
 
@@ -166,14 +336,16 @@ namespace sudoku {
      *
      * @tparam NumFixedRows the number of non-zero entries in sv
      * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
      * @param sv a string_view representing the partial game, with 0s for unfixed cells
      * @return an array usable by DLX
      */
-    template<size_t NumFixedRows, size_t N = 3>
+    template<size_t NumFixedRows, size_t N = 3, unsigned Variants = standard,
+            const auto side = N * N>
     constexpr fixed_rows<NumFixedRows> makeFixedCells(const std::string_view &sv) noexcept {
         fixed_rows<NumFixedRows> rows{};
         int pos = 0;
-        for (size_t i = 0; i < 81; ++i) {
+        for (size_t i = 0; i < side * side; ++i) {
             if (sv[i] == '0')
                 continue;
 
@@ -181,7 +353,7 @@ namespace sudoku {
             // For example A = 10, B = 11, C = 12.
             const auto c = static_cast<size_t>(cToUpper(sv[i]));
             const auto val = (c >= 'A' && c <= 'Z') ? c + 10 - 'A' : c - '0';
-            rows[pos++] = toRow<N>({i / 9, i % 9, val});
+            rows[pos++] = toRow<N, Variants>({i / side, i % side, val});
         }
         return rows;
     }
@@ -195,19 +367,16 @@ namespace sudoku {
      *
      * @tparam NumFixedRows the number of fixed entries in sv
      * @tparam N the size parameter of the Sudoku
-     * @param sv a string_view representing the partial game, with 0s for unfixed cells
-     * @return
+     * @tparam Variants the variant constraints
+     * @param fixed the fixings
+     * @param regions the regions, which are the subgrids unless solving jigsaw Sudoku
+     * @return fist solution found, if one exists
      */
-    template<size_t NumFixedRows, size_t N = 3,
-            const auto rows = N * N,
-            const auto cols = N * N,
-            const auto digits = N * N,
-            const auto totalCols = 4 * (N * N * N * N),
-            const auto arrayRows = rows * cols * digits,
-            const auto arrayNodes = 4 * arrayRows>
-    constexpr std::optional<solution<N>> runSudoku(const fixing_array<NumFixedRows> &fixed) noexcept {
-        return dlx::DLX<totalCols, arrayRows, arrayNodes>::run(makeSudokuPositions<N>(),
-                makeFixedCells<NumFixedRows, N>(fixed));
+    template<size_t NumFixedRows, size_t N = 3, unsigned Variants = standard>
+    constexpr std::optional<solution<N>> runSudoku(const fixing_array<NumFixedRows> &fixed,
+            const region_map<N> &regions = boxRegions<N>()) noexcept {
+        return sudoku_dlx<N, Variants>::run(makeSudokuPositions<N, Variants>(regions),
+                makeFixedCells<NumFixedRows, N, Variants>(fixed));
     }
 
     /**
@@ -217,19 +386,187 @@ namespace sudoku {
      *
      * @tparam NumFixedRows the number of fixed entries in sv
      * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
      * @param sv a string_view representing the partial game, with 0s for unfixed cells
+     * @param regions the regions, which are the subgrids unless solving jigsaw Sudoku
      * @return fist solution found, if one exists
      */
-    template<size_t NumFixedRows, size_t N = 3,
-            const auto rows = N * N,
-            const auto cols = N * N,
-            const auto digits = N * N,
-            const auto totalCols = 4 * (N * N * N * N),
-            const auto arrayRows = rows * cols * digits,
-            const auto arrayNodes = 4 * arrayRows>
-    constexpr std::optional<solution<N>> runSudoku(const std::string_view &sv) noexcept {
-        return dlx::DLX<totalCols, arrayRows, arrayNodes>::run(makeSudokuPositions<N>(),
-                                                               makeFixedCells<NumFixedRows, N>(sv));
+    template<size_t NumFixedRows, size_t N = 3, unsigned Variants = standard>
+    constexpr std::optional<solution<N>> runSudoku(const std::string_view &sv,
+            const region_map<N> &regions = boxRegions<N>()) noexcept {
+        return sudoku_dlx<N, Variants>::run(makeSudokuPositions<N, Variants>(regions),
+                                            makeFixedCells<NumFixedRows, N, Variants>(sv));
+    }
+
+    /**
+     * Parse an N^4 character representation of a board into a board, with 0 indicating an unfixed cell and
+     * values above 9 represented alphabetically, as in makeFixedCells.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param sv a string_view representing the partial game, with 0s for unfixed cells
+     * @return the board
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    constexpr board<N> parseBoard(const std::string_view &sv) noexcept {
+        board<N> b{};
+        for (size_t i = 0; i < side * side; ++i) {
+            const auto c = static_cast<size_t>(cToUpper(sv[i]));
+            b[i / side][i % side] = (c >= 'A' && c <= 'Z') ? c + 10 - 'A' : c - '0';
+        }
+        return b;
+    }
+
+    /**
+     * Count the clues (nonzero cells) of a board.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the board
+     * @return the number of clues
+     */
+    template<size_t N = 3>
+    constexpr size_t countClues(const board<N> &b) noexcept {
+        size_t clues = 0;
+        for (const auto &row: b)
+            for (const auto d: row)
+                if (d) ++clues;
+        return clues;
+    }
+
+    /**
+     * Determine if the clues of a partial board are consistent, i.e. no digit appears twice in a row, column, or
+     * region, or in any of the extra constraint classes of the variant. Only consistent clues may be forced into a
+     * DLX state together.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
+     * @param b the partial board, with 0s for unfixed cells
+     * @param regions the regions, which are the subgrids unless solving jigsaw Sudoku
+     * @return true if the clues are consistent, and false otherwise
+     */
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    constexpr bool isConsistent(const board<N> &b, const region_map<N> &regions = boxRegions<N>()) noexcept {
+        constexpr bool hasDiagonals = Variants & (diagonals | secondary_diagonals);
+        constexpr size_t noHyper = (N - 1) * (N - 1);
+
+        for (size_t p = 0; p < side * side; ++p) {
+            const auto i = p / side;
+            const auto j = p % side;
+            if (b[i][j] > side) return false;
+            if (!b[i][j]) continue;
+
+            for (size_t q = p + 1; q < side * side; ++q) {
+                const auto x = q / side;
+                const auto y = q % side;
+                if (b[x][y] != b[i][j]) continue;
+
+                if (i == x || j == y || regions[i][j] == regions[x][y]) return false;
+                if (hasDiagonals && ((i == j && x == y) || (i + j == side - 1 && x + y == side - 1))) return false;
+                if ((Variants & hyper) && hyperRegion<N>(i, j) != noHyper && hyperRegion<N>(i, j) == hyperRegion<N>(x, y))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Count the completions of a partial board, stopping at limit.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
+     * @param b the partial board, with 0s for unfixed cells
+     * @param limit the number of solutions after which to stop searching
+     * @param regions the regions, which are the subgrids unless solving jigsaw Sudoku
+     * @return the number of completions, capped at limit
+     */
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    size_t countSolutions(const board<N> &b,
+                          size_t limit = std::numeric_limits<size_t>::max(),
+                          const region_map<N> &regions = boxRegions<N>()) noexcept {
+        using DLX = sudoku_dlx<N, Variants>;
+        if (!isConsistent<N, Variants>(b, regions))
+            return 0;
+
+        // The state is large, so keep it off the stack.
+        auto state = std::make_unique<typename DLX::state>(DLX::make_state(makeSudokuPositions<N, Variants>(regions)));
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                if (b[i][j])
+                    DLX::force_row(*state, toRow<N, Variants>({i, j, b[i][j]}));
+        return DLX::count(*state, limit);
+    }
+
+    /**
+     * Determine if a partial board has exactly one completion. The search stops at the second solution.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the partial board, with 0s for unfixed cells
+     * @return true if the board has a unique completion, and false otherwise
+     */
+    template<size_t N = 3>
+    bool isUnique(const board<N> &b) noexcept {
+        return countSolutions<N>(b, 2) == 1;
+    }
+
+    /**
+     * Generate a minimal puzzle from a full grid: clues are removed in an order determined by the seed, and a
+     * clue is kept only if removing it would allow a second solution. The result has a unique solution, namely
+     * grid, and removing any of its clues destroys uniqueness. For 9x9 grids this produces puzzles in the
+     * low-to-mid twenties of clues.
+     *
+     * Since the current puzzle always has grid as its unique solution, a clue (i, j, d) can be removed iff there
+     * is no completion of the remaining clues with something other than d in cell (i, j). Thus instead of a
+     * uniqueness check, each step excludes the row for (i, j, d) and asks for a single solution.
+     *
+     * A single search state is reused throughout: the clues that are kept are forced permanently as they are
+     * decided, and only the clues that have not yet been considered are forced and released around each test.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param grid a complete, valid board
+     * @param seed the seed determining the order in which clues are considered
+     * @return a minimal puzzle whose unique solution is grid
+     */
+    template<size_t N = 3,
+            const auto side = N * N,
+            const auto cells = side * side>
+    board<N> makeMinimalPuzzle(const board<N> &grid, std::uint64_t seed) noexcept {
+        using DLX = sudoku_dlx<N>;
+        static constexpr auto positions = makeSudokuPositions<N>();
+
+        std::array<size_t, cells> order{};
+        for (size_t i = 0; i < cells; ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937_64{seed});
+
+        // The DLX row for each cell in the order in which we consider them.
+        std::array<size_t, cells> rows{};
+        for (size_t i = 0; i < cells; ++i)
+            rows[i] = toRow<N>({order[i] / side, order[i] % side, grid[order[i] / side][order[i] % side]});
+
+        board<N> puzzle = grid;
+        auto state = std::make_unique<typename DLX::state>(DLX::make_state(positions));
+        for (size_t i = 0; i < cells; ++i) {
+            DLX::exclude_row(*state, rows[i]);
+            for (size_t j = i + 1; j < cells; ++j)
+                DLX::force_row(*state, rows[j]);
+
+            const bool needed = DLX::count(*state, 1) > 0;
+
+            for (size_t j = cells; j > i + 1; --j)
+                DLX::release_row(*state, rows[j - 1]);
+            DLX::include_row(*state, rows[i]);
+
+            if (needed)
+                DLX::force_row(*state, rows[i]);
+            else
+                puzzle[order[i] / side][order[i] % side] = 0;
+        }
+
+        return puzzle;
     }
 
     /**
@@ -287,4 +624,1066 @@ namespace sudoku {
     void print_solution(const solution<N> &sol) noexcept {
         print_board<N>(extractBoard<N>(sol));
     }
+
+    /**
+     * Solve a partial board at run time.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @tparam Variants the variant constraints
+     * @param b the partial board, with 0s for unfixed cells
+     * @param regions the regions, which are the subgrids unless solving jigsaw Sudoku
+     * @return the first completion found, if one exists
+     */
+    template<size_t N = 3,
+            unsigned Variants = standard,
+            const auto side = N * N>
+    std::optional<board<N>> solveBoard(const board<N> &b, const region_map<N> &regions = boxRegions<N>()) noexcept {
+        using DLX = sudoku_dlx<N, Variants>;
+        if (!isConsistent<N, Variants>(b, regions))
+            return std::nullopt;
+
+        auto state = std::make_unique<typename DLX::state>(DLX::make_state(makeSudokuPositions<N, Variants>(regions)));
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                if (b[i][j])
+                    DLX::force_row(*state, toRow<N, Variants>({i, j, b[i][j]}));
+
+        const auto sol = DLX::find(*state);
+        if (!sol.has_value())
+            return std::nullopt;
+
+        // The search only reports the cells it filled, so add back the clues.
+        auto result = extractBoard<N>(*sol);
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                if (b[i][j])
+                    result[i][j] = b[i][j];
+        return result;
+    }
+
+    /**
+     * A symmetry of the Sudoku board, i.e. an optional transposition, followed by a permutation of the rows and
+     * of the columns that preserves the bands and stacks, followed by a relabeling of the digits.
+     * The image of a board b under the transform has in cell (i, j) the digit digits[d], where d is the digit of b
+     * at (rows[i], cols[j]) (or at (cols[j], rows[i]) if transposed). Blank cells stay blank, i.e. digits[0] = 0.
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    struct transform {
+        bool transpose = false;
+        std::array<size_t, side> rows{};
+        std::array<size_t, side> cols{};
+        std::array<size_t, side + 1> digits{};
+    };
+
+    /**
+     * The identity transform.
+     * @tparam N the size parameter of the Sudoku
+     * @return a transform that maps every board to itself
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    constexpr transform<N> identityTransform() noexcept {
+        transform<N> t{};
+        for (size_t i = 0; i < side; ++i) {
+            t.rows[i] = i;
+            t.cols[i] = i;
+        }
+        for (size_t d = 0; d <= side; ++d)
+            t.digits[d] = d;
+        return t;
+    }
+
+    /**
+     * Produce a pseudorandom transform, which is useful for disguising puzzles and for testing.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param seed the seed
+     * @return a transform chosen uniformly at random
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    transform<N> randomTransform(std::uint64_t seed) noexcept {
+        std::mt19937_64 gen{seed};
+        transform<N> t = identityTransform<N>();
+        t.transpose = gen() % 2;
+
+        // Permute the bands and stacks, and then the lines within each.
+        for (auto *lines: {&t.rows, &t.cols}) {
+            std::array<size_t, N> blocks{};
+            for (size_t b = 0; b < N; ++b)
+                blocks[b] = b;
+            std::shuffle(blocks.begin(), blocks.end(), gen);
+            for (size_t b = 0; b < N; ++b) {
+                std::array<size_t, N> within{};
+                for (size_t i = 0; i < N; ++i)
+                    within[i] = i;
+                std::shuffle(within.begin(), within.end(), gen);
+                for (size_t i = 0; i < N; ++i)
+                    (*lines)[b * N + i] = blocks[b] * N + within[i];
+            }
+        }
+
+        std::shuffle(t.digits.begin() + 1, t.digits.end(), gen);
+        return t;
+    }
+
+    /**
+     * Apply a transform to a board.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the board
+     * @param t the transform
+     * @return the image of b under t
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    constexpr board<N> applyTransform(const board<N> &b, const transform<N> &t) noexcept {
+        board<N> image{};
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                image[i][j] = t.digits[t.transpose ? b[t.cols[j]][t.rows[i]] : b[t.rows[i]][t.cols[j]]];
+        return image;
+    }
+
+    /**
+     * Apply the inverse of a transform to a board, i.e. applyInverseTransform(applyTransform(b, t), t) == b.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the board
+     * @param t the transform
+     * @return the preimage of b under t
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    constexpr board<N> applyInverseTransform(const board<N> &b, const transform<N> &t) noexcept {
+        std::array<size_t, side + 1> inverse{};
+        for (size_t d = 0; d <= side; ++d)
+            inverse[t.digits[d]] = d;
+
+        board<N> preimage{};
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j) {
+                const auto digit = inverse[b[i][j]];
+                if (t.transpose)
+                    preimage[t.cols[j]][t.rows[i]] = digit;
+                else
+                    preimage[t.rows[i]][t.cols[j]] = digit;
+            }
+        return preimage;
+    }
+
+    namespace details {
+        /// All permutations of {0, ..., N-1} in lexicographic order.
+        template<size_t N>
+        std::vector<std::array<size_t, N>> permutations() {
+            std::array<size_t, N> p{};
+            for (size_t i = 0; i < N; ++i)
+                p[i] = i;
+
+            std::vector<std::array<size_t, N>> perms;
+            do {
+                perms.emplace_back(p);
+            } while (std::next_permutation(p.begin(), p.end()));
+            return perms;
+        }
+
+        /**
+         * The search for the canonical form of a board. For a fixed transposition and column arrangement, the
+         * rows are chosen one at a time, and the digits are relabeled in order of first appearance, which is the
+         * relabeling that minimizes the board for that arrangement. Since boards are compared lexicographically,
+         * at each level only the rows that produce the smallest next row need to be explored, which almost always
+         * leaves a single candidate.
+         *
+         * For the purposes of comparison, blank cells are larger than any digit, so that rows with clues are
+         * preferred early and sparse puzzles tie as rarely as possible.
+         */
+        template<size_t N,
+                const auto side = N * N>
+        class canonicalizer {
+        public:
+            explicit canonicalizer(const board<N> &b): source{b} {}
+
+            std::pair<board<N>, transform<N>> run() {
+                const auto perms = permutations<N>();
+
+                // A mixed-radix counter over the stack permutation and the column permutation in each stack.
+                std::array<size_t, N + 1> counter{};
+                for (bool transpose: {false, true}) {
+                    current.transpose = transpose;
+                    for (size_t i = 0; i < side; ++i)
+                        for (size_t j = 0; j < side; ++j)
+                            grid[i][j] = transpose ? source[j][i] : source[i][j];
+
+                    counter.fill(0);
+                    do {
+                        for (size_t s = 0; s < N; ++s)
+                            for (size_t c = 0; c < N; ++c)
+                                current.cols[s * N + c] = perms[counter[0]][s] * N + perms[counter[s + 1]][c];
+
+                        std::array<size_t, side + 1> labels{};
+                        std::array<bool, side> used{};
+                        extend(0, labels, 1, used, !found);
+
+                        size_t pos = 0;
+                        while (pos <= N && ++counter[pos] == perms.size())
+                            counter[pos++] = 0;
+                        if (pos > N)
+                            break;
+                    } while (true);
+                }
+
+                return {bestBoard, best};
+            }
+
+        private:
+            static constexpr size_t blank = side + 1;
+
+            const board<N> &source;
+
+            // The source board, possibly transposed.
+            board<N> grid{};
+
+            transform<N> current{};
+            std::array<std::array<size_t, side>, side> currentKeys{};
+
+            bool found = false;
+            transform<N> best{};
+            std::array<std::array<size_t, side>, side> bestKeys{};
+            board<N> bestBoard{};
+
+            /**
+             * Choose the row at position level.
+             * @param level the row of the image being chosen
+             * @param labels the relabeling of the digits chosen so far, with 0 meaning unlabeled
+             * @param next the next label to assign
+             * @param used the source rows used so far
+             * @param less true if the image so far is already smaller than the best, or there is no best
+             */
+            void extend(size_t level,
+                        const std::array<size_t, side + 1> &labels,
+                        size_t next,
+                        std::array<bool, side> &used,
+                        bool less) {
+                if (level == side) {
+                    record(labels, next);
+                    return;
+                }
+
+                // Determine the candidates: the first row of a band may come from any unused band, and the
+                // remaining rows from the unused rows of the band of the first row.
+                std::array<size_t, side> candidates{};
+                size_t numCandidates = 0;
+                if (level % N == 0) {
+                    for (size_t r = 0; r < side; ++r)
+                        if (!used[r])
+                            candidates[numCandidates++] = r;
+                } else {
+                    const auto band = current.rows[level - 1] / N;
+                    for (size_t r = band * N; r < band * N + N; ++r)
+                        if (!used[r])
+                            candidates[numCandidates++] = r;
+                }
+
+                // Determine the smallest key among the candidates.
+                std::array<std::array<size_t, side>, side> keys{};
+                size_t minimum = 0;
+                for (size_t c = 0; c < numCandidates; ++c) {
+                    keys[c] = rowKey(candidates[c], labels, next);
+                    if (c > 0 && keys[c] < keys[minimum])
+                        minimum = c;
+                }
+
+                // Prune against the best image found so far.
+                if (!less) {
+                    if (bestKeys[level] < keys[minimum])
+                        return;
+                    less = keys[minimum] < bestKeys[level];
+                }
+
+                for (size_t c = 0; c < numCandidates; ++c) {
+                    if (keys[c] != keys[minimum])
+                        continue;
+
+                    auto childLabels = labels;
+                    auto childNext = next;
+                    const auto r = candidates[c];
+                    for (size_t j = 0; j < side; ++j) {
+                        const auto d = grid[r][current.cols[j]];
+                        if (d && !childLabels[d])
+                            childLabels[d] = childNext++;
+                    }
+
+                    used[r] = true;
+                    current.rows[level] = r;
+                    currentKeys[level] = keys[c];
+                    extend(level + 1, childLabels, childNext, used, less);
+                    used[r] = false;
+
+                    // If a better image was found, the siblings must now be compared against it.
+                    less = false;
+                    if (bestKeys[level] < keys[minimum])
+                        return;
+                }
+            }
+
+            /// The key of a source row under the relabeling, extended in order of first appearance.
+            std::array<size_t, side> rowKey(size_t r, std::array<size_t, side + 1> labels, size_t next) const {
+                std::array<size_t, side> key{};
+                for (size_t j = 0; j < side; ++j) {
+                    const auto d = grid[r][current.cols[j]];
+                    if (!d) {
+                        key[j] = blank;
+                        continue;
+                    }
+                    if (!labels[d])
+                        labels[d] = next++;
+                    key[j] = labels[d];
+                }
+                return key;
+            }
+
+            /// Record the current image as the best, if it is.
+            void record(const std::array<size_t, side + 1> &labels, size_t next) {
+                if (found && !(currentKeys < bestKeys))
+                    return;
+
+                found = true;
+                bestKeys = currentKeys;
+                best = current;
+
+                // Complete the relabeling to a permutation by labeling the absent digits in increasing order.
+                best.digits = labels;
+                for (size_t d = 1; d <= side; ++d)
+                    if (!best.digits[d])
+                        best.digits[d] = next++;
+                best.digits[0] = 0;
+
+                for (size_t i = 0; i < side; ++i)
+                    for (size_t j = 0; j < side; ++j)
+                        bestBoard[i][j] = bestKeys[i][j] == blank ? 0 : bestKeys[i][j];
+            }
+        };
+    }
+
+    /**
+     * Compute the canonical form of a board under the symmetries of Sudoku, i.e. transposition, permutations of
+     * the bands and stacks, permutations of the rows (columns) within a band (stack), and relabelings of the
+     * digits. Two boards are equivalent iff they have the same canonical form, and the returned transform t
+     * satisfies applyTransform(b, t) == canonical form.
+     *
+     * The search fixes a transposition and one of the (N!)^(N+1) column arrangements at a time and chooses the
+     * rows greedily, so this is fast for N = 3 (a few thousand arrangements), but impractical for N >= 4.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the board, which may be partial
+     * @return the canonical form and a transform mapping b to it
+     */
+    template<size_t N = 3>
+    std::pair<board<N>, transform<N>> canonicalForm(const board<N> &b) {
+        return details::canonicalizer<N>{b}.run();
+    }
+
+    /**
+     * A cache of solutions keyed by canonical form, so that repeated and equivalent queries are answered by a
+     * lookup. Solutions are stored for the canonical puzzle and mapped back through the inverse of the transform
+     * that canonicalized the query.
+     *
+     * @tparam N the size parameter of the Sudoku
+     */
+    template<size_t N = 3>
+    class solution_cache {
+    public:
+        /**
+         * Solve a puzzle, consulting and populating the cache.
+         * @param puzzle the partial board, with 0s for unfixed cells
+         * @return a completion of puzzle, if one exists
+         */
+        std::optional<board<N>> solve(const board<N> &puzzle) {
+            const auto [canonical, t] = canonicalForm<N>(puzzle);
+
+            auto iter = cache.find(canonical);
+            if (iter == cache.end()) {
+                ++numMisses;
+                iter = cache.emplace(canonical, solveBoard<N>(canonical)).first;
+            } else {
+                ++numHits;
+            }
+
+            if (!iter->second.has_value())
+                return std::nullopt;
+            return applyInverseTransform<N>(*iter->second, t);
+        }
+
+        /// The number of distinct canonical puzzles in the cache.
+        size_t size() const noexcept { return cache.size(); }
+
+        /// The number of queries answered from the cache.
+        size_t hits() const noexcept { return numHits; }
+
+        /// The number of queries that required solving.
+        size_t misses() const noexcept { return numMisses; }
+
+    private:
+        std::map<board<N>, std::optional<board<N>>> cache;
+        size_t numHits = 0;
+        size_t numMisses = 0;
+    };
+
+    /// The number of completions of a board, which for the empty 9x9 board exceeds 64 bits.
+    using count_type = unsigned __int128;
+
+    /**
+     * Convert a count to its decimal representation.
+     * @param count the count
+     * @return the count in decimal
+     */
+    inline std::string countToString(count_type count) {
+        std::string digits;
+        do {
+            digits += static_cast<char>('0' + static_cast<int>(count % 10));
+            count /= 10;
+        } while (count);
+        return {digits.rbegin(), digits.rend()};
+    }
+
+    /// The top band of a board, i.e. its first N rows.
+    template<size_t N = 3>
+    using band = std::array<std::array<size_t, N * N>, N>;
+
+    namespace details {
+        /**
+         * Encode the part of a band outside of the first box in base N^2, which for N <= 3 fits in 64 bits.
+         * The first box is always 1, ..., N^2 in row-major order, and so is not encoded.
+         */
+        template<size_t N,
+                const auto side = N * N>
+        std::uint64_t encodeBand(const band<N> &b) noexcept {
+            static_assert(N <= 3, "Bands are only encoded for N <= 3");
+            std::uint64_t code = 0;
+            for (size_t r = 0; r < N; ++r)
+                for (size_t c = N; c < side; ++c)
+                    code = code * side + (b[r][c] - 1);
+            return code;
+        }
+
+        /**
+         * Bring a band into reduced form: relabel it so that its first box is 1, ..., N^2 in row-major order, sort
+         * the columns of every other stack by their top entries, and then sort those stacks by their top left
+         * entries. None of these operations changes the number of completions of the band.
+         */
+        template<size_t N,
+                const auto side = N * N>
+        band<N> reduceBand(const band<N> &b) noexcept {
+            std::array<size_t, side + 1> labels{};
+            for (size_t r = 0; r < N; ++r)
+                for (size_t c = 0; c < N; ++c)
+                    labels[b[r][c]] = r * N + c + 1;
+
+            // Order the columns of each stack by their top entries. These are distinct, so insertion sort on the
+            // column indices suffices.
+            std::array<size_t, side> cols{};
+            for (size_t s = 0; s < N; ++s)
+                for (size_t c = s * N; c < s * N + N; ++c) {
+                    size_t pos = c;
+                    while (s > 0 && pos > s * N && labels[b[0][cols[pos - 1]]] > labels[b[0][c]]) {
+                        cols[pos] = cols[pos - 1];
+                        --pos;
+                    }
+                    cols[pos] = c;
+                }
+
+            // Order the stacks other than the first by their top left entries.
+            std::array<size_t, N> stacks{};
+            for (size_t s = 0; s < N; ++s) {
+                size_t pos = s;
+                while (pos > 1 && labels[b[0][cols[stacks[pos - 1] * N]]] > labels[b[0][cols[s * N]]]) {
+                    stacks[pos] = stacks[pos - 1];
+                    --pos;
+                }
+                stacks[pos] = s;
+            }
+
+            band<N> reduced{};
+            for (size_t s = 0; s < N; ++s)
+                for (size_t c = 0; c < N; ++c)
+                    for (size_t r = 0; r < N; ++r)
+                        reduced[r][s * N + c] = labels[b[r][cols[stacks[s] * N + c]]];
+            return reduced;
+        }
+
+        /// Enumerate the fillings of the top band that are in reduced form.
+        template<size_t N,
+                const auto side = N * N>
+        void enumerateBands(band<N> &b, size_t cell, std::vector<band<N>> &bands) {
+            constexpr auto cellsPerRow = side - N;
+            if (cell == N * cellsPerRow) {
+                bands.emplace_back(b);
+                return;
+            }
+
+            const auto r = cell / cellsPerRow;
+            const auto c = N + cell % cellsPerRow;
+            for (size_t d = 1; d <= side; ++d) {
+                // The top row increases within each stack, and along the tops of the stacks.
+                if (r == 0 && c % N != 0 && d < b[0][c - 1]) continue;
+                if (r == 0 && c % N == 0 && c > N && d < b[0][c - N]) continue;
+
+                bool free = true;
+                for (size_t k = 0; k < c && free; ++k)
+                    free = b[r][k] != d;
+                for (size_t k = 0; k < r && free; ++k)
+                    for (size_t x = N * (c / N); x < N * (c / N) + N && free; ++x)
+                        free = b[k][x] != d;
+                if (!free)
+                    continue;
+
+                b[r][c] = d;
+                enumerateBands<N>(b, cell + 1, bands);
+            }
+            b[r][c] = 0;
+        }
+    }
+
+    /**
+     * Partition the fillings of the top band (with the first box fixed to 1, ..., N^2) into classes whose members
+     * have the same number of completions to a full board. Two fillings are in the same class if one can be
+     * obtained from the other by permuting the columns within stacks, the stacks, and the rows of the band, and
+     * then relabeling the digits to restore the first box.
+     *
+     * This is the reduction used by Felgenhauer and Jarvis. First, sorting the columns of the stacks other than
+     * the first, and then those stacks, acts freely, so only fillings in this reduced form are enumerated (36288
+     * for N = 3), each standing for (N!)^(N-1) (N-1)! fillings. The remaining symmetries are covered by choosing
+     * the stack that moves to the front, its column order, and the row order, so the class of a reduced filling is
+     * identified by the least reduced image over these N (N!)^2 choices. For N = 3, this gives 416 classes.
+     *
+     * @tparam N the size parameter of the Sudoku, at most 3
+     * @return a representative of each class, along with the size of the class
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    std::vector<std::pair<band<N>, size_t>> bandClasses() {
+        static_assert(N <= 3, "Band classes are only computed for N <= 3");
+
+        band<N> b{};
+        for (size_t r = 0; r < N; ++r)
+            for (size_t c = 0; c < N; ++c)
+                b[r][c] = r * N + c + 1;
+        std::vector<band<N>> bands;
+        details::enumerateBands<N>(b, 0, bands);
+
+        // The number of fillings represented by each reduced filling, i.e. (N!)^(N-1) (N-1)!.
+        size_t factorial = 1;
+        for (size_t i = 2; i < N; ++i)
+            factorial *= i;
+        size_t weight = factorial;
+        for (size_t s = 1; s < N; ++s)
+            weight *= factorial * N;
+
+        const auto perms = details::permutations<N>();
+        std::map<std::uint64_t, std::pair<band<N>, size_t>> classes;
+        for (const auto &f: bands) {
+            std::uint64_t bestCode = std::numeric_limits<std::uint64_t>::max();
+            band<N> best{};
+            for (size_t front = 0; front < N; ++front)
+                for (const auto &colPerm: perms)
+                    for (const auto &rowPerm: perms) {
+                        // The stack order: front first, and the others in their original order.
+                        std::array<size_t, side> cols{};
+                        for (size_t c = 0; c < N; ++c)
+                            cols[c] = front * N + colPerm[c];
+                        for (size_t s = 0, pos = 1; s < N; ++s) {
+                            if (s == front) continue;
+                            for (size_t c = 0; c < N; ++c)
+                                cols[pos * N + c] = s * N + c;
+                            ++pos;
+                        }
+
+                        band<N> image{};
+                        for (size_t r = 0; r < N; ++r)
+                            for (size_t c = 0; c < side; ++c)
+                                image[r][c] = f[rowPerm[r]][cols[c]];
+                        image = details::reduceBand<N>(image);
+
+                        const auto code = details::encodeBand<N>(image);
+                        if (code < bestCode) {
+                            bestCode = code;
+                            best = image;
+                        }
+                    }
+
+            auto &entry = classes[bestCode];
+            entry.first = best;
+            entry.second += weight;
+        }
+
+        std::vector<std::pair<band<N>, size_t>> result;
+        for (const auto &[code, entry]: classes)
+            result.emplace_back(entry);
+        return result;
+    }
+
+    namespace details {
+        /**
+         * The ways of filling one lower band of a board with top band b, for N = 3, grouped by the digits in each
+         * of its columns, i.e. its column triples.
+         *
+         * Each digit appears in the first band once per stack, and must appear in the other two columns of that
+         * stack once in each lower band. So a stack of a lower band is given by choosing, for each of its columns,
+         * three of the six digits missing from it so that the three columns together hold every digit once, and the
+         * other band then gets the three digits left over. For each such choice, arrangements lists the ways of
+         * assigning the digits of each column to the rows of the band, as the set of digits in each row.
+         */
+        template<size_t N = 3,
+                const auto side = N * N>
+        struct stack_triples {
+            using mask = std::uint16_t;
+            using rows = std::array<mask, N>;
+
+            /// The digits of the columns of the stack in the band, as masks.
+            std::vector<std::array<mask, N>> triples;
+
+            /// The index in triples of the triples of the other lower band.
+            std::vector<size_t> complement;
+
+            /// The sets of digits in the rows of the stack, for each of the (N!)^N arrangements of its columns.
+            std::vector<std::vector<rows>> arrangements;
+        };
+
+        /// The column triples of stack s of the lower bands below a top band.
+        template<size_t N = 3,
+                const auto side = N * N>
+        stack_triples<N> stackTriples(const band<N> &b, size_t s) {
+            static_assert(N == 3, "Column triples are only used for N = 3");
+            using mask = typename stack_triples<N>::mask;
+            constexpr mask all = (1 << side) - 1;
+
+            std::array<mask, N> missing{};
+            for (size_t c = 0; c < N; ++c) {
+                missing[c] = all;
+                for (size_t r = 0; r < N; ++r)
+                    missing[c] &= ~(1 << (b[r][s * N + c] - 1));
+            }
+
+            // The subsets of N digits of each column, chosen column by column so that they are disjoint.
+            stack_triples<N> st;
+            std::array<mask, N> triple{};
+            const auto choose = [&](const auto &self, size_t c, mask used) -> void {
+                if (c == N) {
+                    st.triples.emplace_back(triple);
+                    return;
+                }
+                for (mask m = 0; m <= all; ++m)
+                    if (__builtin_popcount(m) == N && (m & ~missing[c]) == 0 && (m & used) == 0) {
+                        triple[c] = m;
+                        self(self, c + 1, used | m);
+                    }
+            };
+            choose(choose, 0, 0);
+
+            const auto perms = permutations<N>();
+            for (const auto &t: st.triples) {
+                std::array<mask, N> other{};
+                for (size_t c = 0; c < N; ++c)
+                    other[c] = missing[c] & ~t[c];
+                st.complement.emplace_back(
+                        std::find(st.triples.cbegin(), st.triples.cend(), other) - st.triples.cbegin());
+
+                // The arrangements, with the first column last to vary, so that the first N! of them place the
+                // digits of the first column in increasing order down the rows.
+                std::array<std::array<size_t, N>, N> digits{};
+                for (size_t c = 0; c < N; ++c)
+                    for (size_t d = 0, k = 0; d < side; ++d)
+                        if (t[c] & (1 << d))
+                            digits[c][k++] = d;
+
+                std::vector<typename stack_triples<N>::rows> arrangements;
+                for (const auto &p0: perms)
+                    for (const auto &p1: perms)
+                        for (const auto &p2: perms) {
+                            const std::array<const std::array<size_t, N> *, N> p{&p0, &p1, &p2};
+                            typename stack_triples<N>::rows rs{};
+                            for (size_t c = 0; c < N; ++c)
+                                for (size_t k = 0; k < N; ++k)
+                                    rs[(*p[c])[k]] |= 1 << digits[c][k];
+                            arrangements.emplace_back(rs);
+                        }
+                st.arrangements.emplace_back(std::move(arrangements));
+            }
+            return st;
+        }
+
+        /**
+         * Count the completions of a top band to a full board, for N = 3, in the manner of Felgenhauer and Jarvis.
+         *
+         * The number of fillings of a lower band depends only on its column triples, and the column triples of the
+         * second band determine those of the third. Thus, the completions are the sum, over the column triples
+         * t1, t2, t3 of the stacks of the second band, of the number of fillings of the second band with these
+         * triples times the number of fillings of the third band with the triples left over.
+         *
+         * The number of fillings of a band is counted by stacks: the rows of the first two stacks must be disjoint,
+         * and the rows of the third stack are then the digits left over. For each t1 and t2, the left over rows are
+         * tallied once, and then looked up for each arrangement of every t3. Permuting the rows of the band acts
+         * freely on the arrangements of the first stack, so only those with the first column in order are tried.
+         *
+         * @param b the top band
+         * @return the number of boards with top band b
+         */
+        template<size_t N = 3,
+                const auto side = N * N>
+        std::uint64_t countLowerBands(const band<N> &b) {
+            static_assert(N == 3, "Lower bands are only counted by column triples for N = 3");
+            using mask = typename stack_triples<N>::mask;
+            constexpr mask all = (1 << side) - 1;
+
+            // Number the ordered partitions of the digits into N rows of N by their first N - 1 rows.
+            std::vector<std::uint16_t> partition(1 << (side * (N - 1)), 0);
+            std::uint16_t partitions = 0;
+            for (mask r0 = 0; r0 <= all; ++r0)
+                for (mask r1 = 0; r1 <= all; ++r1)
+                    if (__builtin_popcount(r0) == N && __builtin_popcount(r1) == N && (r0 & r1) == 0)
+                        partition[r0 | r1 << side] = partitions++;
+            const auto key = [&partition](mask r0, mask r1) { return partition[r0 | r1 << side]; };
+
+            std::array<stack_triples<N>, N> stacks;
+            for (size_t s = 0; s < N; ++s)
+                stacks[s] = stackTriples<N>(b, s);
+            const auto &[s1, s2, s3] = stacks;
+            const auto n1 = s1.triples.size();
+            const auto n2 = s2.triples.size();
+            const auto n3 = s3.triples.size();
+
+            std::vector<std::vector<std::uint16_t>> keys3(n3);
+            for (size_t k = 0; k < n3; ++k)
+                for (const auto &rs: s3.arrangements[k])
+                    keys3[k].emplace_back(key(rs[0], rs[1]));
+
+            // The N! orders of the rows, and the arrangements of the first stack with its first column in order.
+            constexpr size_t rowOrders = 6;
+            constexpr size_t firstStack = rowOrders * rowOrders;
+            std::vector<std::uint64_t> fillings(n1 * n2 * n3);
+            std::vector<std::uint64_t> leftOver(partitions);
+            for (size_t i = 0; i < n1; ++i)
+                for (size_t j = 0; j < n2; ++j) {
+                    std::fill(leftOver.begin(), leftOver.end(), 0);
+                    for (size_t x = 0; x < firstStack; ++x) {
+                        const auto &a = s1.arrangements[i][x];
+                        for (const auto &c: s2.arrangements[j])
+                            if (!(a[0] & c[0]) && !(a[1] & c[1]) && !(a[2] & c[2]))
+                                ++leftOver[key(all & ~(a[0] | c[0]), all & ~(a[1] | c[1]))];
+                    }
+
+                    for (size_t k = 0; k < n3; ++k) {
+                        std::uint64_t count = 0;
+                        for (const auto p: keys3[k])
+                            count += leftOver[p];
+                        fillings[(i * n2 + j) * n3 + k] = rowOrders * count;
+                    }
+                }
+
+            std::uint64_t total = 0;
+            for (size_t i = 0; i < n1; ++i)
+                for (size_t j = 0; j < n2; ++j)
+                    for (size_t k = 0; k < n3; ++k)
+                        total += fillings[(i * n2 + j) * n3 + k]
+                                 * fillings[(s1.complement[i] * n2 + s2.complement[j]) * n3 + s3.complement[k]];
+            return total;
+        }
+    }
+
+    /**
+     * Count the completions of the empty board using the band classes of bandClasses: the number of full boards
+     * is (N^2)! (for the labeling of the first box) times the sum over the classes of the size of the class and
+     * the number of completions of its representative. For N = 3, the completions are counted by the column
+     * triples of the lower bands, as in details::countLowerBands, and otherwise with DLX, in parallel.
+     *
+     * @tparam N the size parameter of the Sudoku, at most 3
+     * @param threads the number of threads to use
+     * @return the number of Sudoku boards
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    count_type countGrids(size_t threads = std::thread::hardware_concurrency()) {
+        const auto classes = bandClasses<N>();
+
+        std::vector<std::uint64_t> completions(classes.size());
+        dlx::parallel_for(classes.size(), threads, [&](size_t i) {
+            if constexpr (N == 3)
+                completions[i] = details::countLowerBands<N>(classes[i].first);
+            else {
+                board<N> b{};
+                for (size_t r = 0; r < N; ++r)
+                    b[r] = classes[i].first[r];
+                completions[i] = countSolutions<N>(b);
+            }
+        });
+
+        count_type total = 0;
+        for (size_t i = 0; i < classes.size(); ++i)
+            total += static_cast<count_type>(classes[i].second) * completions[i];
+        for (size_t d = 2; d <= side; ++d)
+            total *= d;
+        return total;
+    }
+
+    /**
+     * Count the completions of a partial board in parallel and exactly.
+     *
+     * The empty board is handled by countGrids. Otherwise, the board is split into subproblems by repeatedly
+     * branching on the empty cell with the fewest candidates until there are enough subproblems to keep the
+     * threads busy. Subproblems that are equivalent under the symmetries of Sudoku have the same number of
+     * completions, so for N <= 3 only one subproblem per canonical form is counted.
+     *
+     * @tparam N the size parameter of the Sudoku
+     * @param b the partial board, with 0s for unfixed cells
+     * @param threads the number of threads to use
+     * @return the number of completions of b
+     */
+    template<size_t N = 3,
+            const auto side = N * N>
+    count_type countCompletions(const board<N> &b, size_t threads = std::thread::hardware_concurrency()) {
+        if (!isConsistent<N>(b))
+            return 0;
+        if constexpr (N <= 3)
+            if (countClues<N>(b) == 0)
+                return countGrids<N>(threads);
+
+        // Split the board into subproblems, breadth first.
+        std::vector<board<N>> tasks{b};
+        const auto wanted = 16 * std::max<size_t>(1, threads);
+        bool split = true;
+        while (split && !tasks.empty() && tasks.size() < wanted) {
+            split = false;
+            std::vector<board<N>> next;
+            for (const auto &task: tasks) {
+                // Find the empty cell with the fewest candidates.
+                size_t bestCell = side * side;
+                std::vector<size_t> bestDigits;
+                for (size_t cell = 0; cell < side * side; ++cell) {
+                    if (task[cell / side][cell % side]) continue;
+
+                    std::vector<size_t> digits;
+                    auto candidate = task;
+                    for (size_t d = 1; d <= side; ++d) {
+                        candidate[cell / side][cell % side] = d;
+                        if (isConsistent<N>(candidate))
+                            digits.emplace_back(d);
+                    }
+                    if (bestCell == side * side || digits.size() < bestDigits.size()) {
+                        bestCell = cell;
+                        bestDigits = std::move(digits);
+                    }
+                }
+
+                // Full boards cannot be split further.
+                if (bestCell == side * side) {
+                    next.emplace_back(task);
+                    continue;
+                }
+
+                split = true;
+                for (const auto d: bestDigits) {
+                    auto child = task;
+                    child[bestCell / side][bestCell % side] = d;
+                    next.emplace_back(child);
+                }
+            }
+            tasks = std::move(next);
+        }
+
+        // Group equivalent subproblems.
+        std::map<board<N>, size_t> multiplicity;
+        for (const auto &task: tasks) {
+            if constexpr (N <= 3)
+                ++multiplicity[canonicalForm<N>(task).first];
+            else
+                ++multiplicity[task];
+        }
+
+        std::vector<std::pair<board<N>, size_t>> classes{multiplicity.cbegin(), multiplicity.cend()};
+        std::vector<size_t> completions(classes.size());
+        dlx::parallel_for(classes.size(), threads, [&](size_t i) {
+            completions[i] = countSolutions<N>(classes[i].first);
+        });
+
+        count_type total = 0;
+        for (size_t i = 0; i < classes.size(); ++i)
+            total += static_cast<count_type>(classes[i].second) * completions[i];
+        return total;
+    }
+
+    /** RUNTIME ORDER **/
+
+    /**
+     * A board whose size parameter N is only known at run time: an N^2 by N^2 grid of entries from 0 to N^2,
+     * with 0 indicating an unfixed cell.
+     */
+    using runtime_board = std::vector<std::vector<size_t>>;
+
+    /**
+     * Create the standard formulation of makeSudokuPositions for a size parameter N given at run time. The columns
+     * and the rows are laid out exactly as they are there, so the row for digit d in cell (i,j) starts at node
+     * 4 (i N^4 + j N^2 + d - 1), as given by toRow.
+     *
+     * @param N the size parameter of the Sudoku
+     * @return the positions of the formulation
+     */
+    inline dlx::position_vector makeRuntimeSudokuPositions(size_t N) {
+        const auto side = N * N;
+        const auto block = static_cast<int>(side * side);
+
+        dlx::position_vector positions;
+        positions.reserve(4 * side * side * side);
+
+        int row = 0;
+        for (size_t i = 0; i < side; ++i)
+            for (size_t j = 0; j < side; ++j)
+                for (size_t n = 0; n < side; ++n) {
+                    const auto region = (i / N) * N + j / N;
+                    positions.emplace_back(row, static_cast<int>(i * side + n));
+                    positions.emplace_back(row, static_cast<int>(block + j * side + n));
+                    positions.emplace_back(row, static_cast<int>(2 * block + region * side + n));
+                    positions.emplace_back(row, static_cast<int>(3 * block + i * side + j));
+                    ++row;
+                }
+        return positions;
+    }
+
+    /**
+     * The solver for the size parameter N, which is built the first time it is requested and shared thereafter.
+     * It holds the empty board: callers copy it and force their clues into the copy, which is far cheaper than
+     * rebuilding the formulation. The state is kept on the heap, so this scales to boards (e.g. 25x25) whose
+     * state does not fit on the stack.
+     *
+     * @param N the size parameter of the Sudoku
+     * @return the shared solver for the empty board
+     */
+    inline const dlx::RuntimeDLX &runtimeSolver(size_t N) {
+        static std::mutex mutex;
+        static std::map<size_t, std::unique_ptr<dlx::RuntimeDLX>> solvers;
+
+        const std::lock_guard<std::mutex> lock{mutex};
+        auto &solver = solvers[N];
+        if (!solver) {
+            const auto side = N * N;
+            solver = std::make_unique<dlx::RuntimeDLX>(4 * side * side, side * side * side,
+                                                       makeRuntimeSudokuPositions(N));
+        }
+        return *solver;
+    }
+
+    /**
+     * Parse an N^4 character representation of a board, as in parseBoard, for a size parameter N given at
+     * run time.
+     *
+     * @param N the size parameter of the Sudoku
+     * @param sv a string_view representing the partial game, with 0s for unfixed cells
+     * @return the board
+     */
+    inline runtime_board parseRuntimeBoard(size_t N, const std::string_view &sv) {
+        const auto side = N * N;
+        runtime_board b(side, std::vector<size_t>(side));
+        for (size_t i = 0; i < side * side; ++i) {
+            const auto c = static_cast<size_t>(cToUpper(sv[i]));
+            b[i / side][i % side] = (c >= 'A' && c <= 'Z') ? c + 10 - 'A' : c - '0';
+        }
+        return b;
+    }
+
+    /**
+     * Determine if the clues of a partial board of size parameter N given at run time are consistent, as in
+     * isConsistent for the standard Sudoku.
+     *
+     * @param N the size parameter of the Sudoku
+     * @param b the partial board, with 0s for unfixed cells
+     * @return true if the board has the right shape and its clues are consistent, and false otherwise
+     */
+    inline bool isConsistent(size_t N, const runtime_board &b) {
+        const auto side = N * N;
+        if (b.size() != side)
+            return false;
+
+        // Mark each digit as seen in its row, column, and region.
+        std::vector<bool> seen(3 * side * side, false);
+        for (size_t i = 0; i < side; ++i) {
+            if (b[i].size() != side)
+                return false;
+            for (size_t j = 0; j < side; ++j) {
+                const auto d = b[i][j];
+                if (!d) continue;
+                if (d > side) return false;
+
+                const auto region = (i / N) * N + j / N;
+                for (const auto idx: {i * side + d - 1, (side + j) * side + d - 1, (2 * side + region) * side + d - 1}) {
+                    if (seen[idx]) return false;
+                    seen[idx] = true;
+                }
+            }
+        }
+        return true;
+    }
+
+    namespace details {
+        /**
+         * Copy the shared solver for N and force the clues of a board into the copy.
+         *
+         * @param N the size parameter of the Sudoku
+         * @param b the partial board, which must be consistent
+         * @return the solver with the clues forced
+         */
+        inline dlx::RuntimeDLX runtimeSolverFor(size_t N, const runtime_board &b) {
+            const auto side = N * N;
+            auto solver = runtimeSolver(N);
+            for (size_t i = 0; i < side; ++i)
+                for (size_t j = 0; j < side; ++j)
+                    if (b[i][j])
+                        solver.force_row(4 * (i * side * side + j * side + b[i][j] - 1));
+            return solver;
+        }
+    }
+
+    /**
+     * Solve a partial board of size parameter N given at run time.
+     *
+     * The search always branches on the column with the fewest remaining rows. A cell with one candidate left
+     * or a digit with one place left in a row, column, or region is such a column, so the naked and hidden
+     * singles are filled in before any guess is made. Nothing stronger is propagated, so the time taken depends
+     * on how much guessing the singles leave.
+     *
+     * @param N the size parameter of the Sudoku
+     * @param b the partial board, with 0s for unfixed cells
+     * @return the first completion found, if one exists
+     */
+    inline std::optional<runtime_board> solveRuntimeBoard(size_t N, const runtime_board &b) {
+        if (!isConsistent(N, b))
+            return std::nullopt;
+
+        const auto side = N * N;
+        auto solver = details::runtimeSolverFor(N, b);
+        const auto sol = solver.run();
+        if (!sol.has_value())
+            return std::nullopt;
+
+        // The solution includes the forced rows, so it describes the whole board.
+        runtime_board result(side, std::vector<size_t>(side));
+        for (size_t row = 0; row < sol->size(); ++row)
+            if ((*sol)[row])
+                result[row / (side * side)][(row / side) % side] = row % side + 1;
+        return result;
+    }
+
+    /**
+     * Count the completions of a partial board of size parameter N given at run time, stopping at limit.
+     *
+     * @param N the size parameter of the Sudoku
+     * @param b the partial board, with 0s for unfixed cells
+     * @param limit the number of solutions after which to stop searching
+     * @return the number of completions, capped at limit
+     */
+    inline size_t countRuntimeSolutions(size_t N, const runtime_board &b,
+                                        size_t limit = std::numeric_limits<size_t>::max()) {
+        if (!isConsistent(N, b))
+            return 0;
+        return details::runtimeSolverFor(N, b).count(limit);
+    }
 }
@@ -4,8 +4,11 @@
  * By Sebastian Raaphorst, 2018.
  */
 
+#include <array>
 #include <iostream>
+#include <limits>
 #include <optional>
+#include <stdexcept>
 
 #include <catch.hpp>
 #include <dlx_contexpr.h>
@@ -21,6 +24,24 @@ TEST_CASE("C(11, 4)") {
     REQUIRE(f2 == 330);
 }
 
+TEST_CASE("Binomial coefficients at the limit of factype") {
+    constexpr auto largest = nCr(maxBinomialN, maxBinomialN / 2);
+    REQUIRE(largest == 14226520737620288370ULL);
+    REQUIRE(pascalTriangle<maxBinomialN>[maxBinomialN][maxBinomialN / 2] == largest);
+    REQUIRE(nCr(100, 3) == 161700);
+    REQUIRE(nCr(3, 100) == 0);
+    REQUIRE(nCr(5000000000ULL, 2) == 12499999997500000000ULL);
+    REQUIRE_THROWS_AS(nCr(100, 50), std::overflow_error);
+
+    constexpr auto v = maxBinomialN;
+    constexpr auto k = 3;
+    constexpr std::array<factype, k> last{v - 3, v - 2, v - 1};
+    REQUIRE(rankKSubset<v, k>(last) == nCr(v, k) - 1);
+    REQUIRE(unrankKSubset<v, k>(nCr(v, k) - 1) == last);
+    for (factype rk = 0; rk < nCr(v, k); rk += 997)
+        REQUIRE(rankKSubset<v, k>(unrankKSubset<v, k>(rk)) == rk);
+}
+
 TEST_CASE("Ranking and unranking 3-sets of [8]") {
     constexpr auto v = 8;
     constexpr auto k = 3;
@@ -71,6 +92,11 @@ TEST_CASE("STS(15)") {
 TEST_CASE("No STS(8)") {
     constexpr auto solution = cmath::run_t_design<8, 3, 2>();
     REQUIRE(!solution);
+
+    // The divisibility conditions rule STS(8) out before searching, so check that the search agrees.
+    REQUIRE(!isAdmissible(8, 3, 2));
+    constexpr auto search = dlx::DLX<nCr(8, 2), nCr(8, 3), 3 * nCr(8, 3)>::run(makeDesignPositions<8, 3, 2>());
+    REQUIRE(!search);
 }
 
 TEST_CASE("SQS(8)") {
@@ -83,4 +109,307 @@ TEST_CASE("SQS(10)") {
     constexpr auto solution = cmath::run_t_design<10, 4, 3>();
     REQUIRE(solution);
     cmath::print_solution<10, 4>(solution);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Incremental design formulation") {
+    // The formulation is the one obtained by unranking each row and ranking each of its t-subsets.
+    constexpr auto positions = makeDesignPositions<10, 4, 3>();
+    size_t node = 0;
+    for (factype row = 0; row < nCr(10, 4); ++row) {
+        const auto kset = unrankKSubset<10, 4>(row);
+        for (factype col = 0; col < nCr(4, 3); ++col) {
+            const auto tsetIdx = unrankKSubset<4, 3>(col);
+            std::array<factype, 3> tset{};
+            for (size_t i = 0; i < 3; ++i)
+                tset[i] = kset[tsetIdx[i]];
+            REQUIRE(positions[node].first == row);
+            REQUIRE(positions[node].second == rankKSubset<10, 3>(tset));
+            ++node;
+        }
+    }
+    REQUIRE(node == positions.size());
+
+    // The streamed formulation agrees with the constexpr one, whatever the chunk size.
+    for (const size_t chunkRows: {1, 7, 1000}) {
+        node = 0;
+        factype nextRow = 0;
+        streamDesignRows(10, 4, 3, chunkRows, [&](const design_chunk &chunk) {
+            REQUIRE(chunk.firstRow == nextRow);
+            REQUIRE(chunk.offsets.size() <= chunkRows + 1);
+            for (size_t r = 0; r + 1 < chunk.offsets.size(); ++r)
+                for (auto idx = chunk.offsets[r]; idx < chunk.offsets[r + 1]; ++idx) {
+                    REQUIRE(positions[node].first == chunk.firstRow + r);
+                    REQUIRE(positions[node].second == chunk.columns[idx]);
+                    ++node;
+                }
+            nextRow += chunk.offsets.size() - 1;
+        });
+        REQUIRE(node == positions.size());
+    }
+
+    // A formulation too large for a position_array can be processed chunk by chunk.
+    factype nodes = 0;
+    streamDesignRows(100, 3, 2, 4096, [&nodes](const design_chunk &chunk) {
+        nodes += chunk.columns.size();
+    });
+    REQUIRE(nodes == 3 * nCr(100, 3));
+
+    // Row and column numbers that do not fit in a dlx::position are not truncated.
+    REQUIRE(toPositionIndex(std::numeric_limits<int>::max()) == std::numeric_limits<int>::max());
+    REQUIRE_THROWS_AS(toPositionIndex(size_t{1} << 31u), std::overflow_error);
+
+    const auto sts = dlx::RuntimeDLX{nCr(9, 2), nCr(9, 3), makeRuntimeDesignPositions(9, 3, 2)}.run();
+    REQUIRE(sts);
+    REQUIRE(std::count(sts->cbegin(), sts->cend(), true) == 12);
+}
+
+/// Check that every t-set of [v] is in exactly one block.
+static bool isDesign(factype v, factype t, const std::vector<std::vector<factype>> &blocks) {
+    std::vector<size_t> occurrences(nCr(v, t));
+    for (const auto &block: blocks)
+        for (factype rk = 0; rk < occurrences.size(); ++rk) {
+            const auto tset = unrankSubset(v, t, rk);
+            if (std::includes(block.cbegin(), block.cend(), tset.cbegin(), tset.cend()))
+                ++occurrences[rk];
+        }
+    return std::all_of(occurrences.cbegin(), occurrences.cend(), [](auto o) { return o == 1; });
+}
+
+TEST_CASE("Lazy t-designs") {
+    for (factype rk = 0; rk < nCr(12, 4); ++rk)
+        REQUIRE(rankSubset(12, unrankSubset(12, 4, rk)) == rk);
+
+    const auto sts7 = run_t_design_lazy(7, 3, 2);
+    REQUIRE(sts7);
+    REQUIRE(sts7->size() == 7);
+    REQUIRE(isDesign(7, 2, *sts7));
+
+    REQUIRE(!run_t_design_lazy(8, 3, 2));
+
+    const auto sqs10 = run_t_design_lazy(10, 4, 3);
+    REQUIRE(sqs10);
+    REQUIRE(sqs10->size() == 30);
+    REQUIRE(isDesign(10, 3, *sqs10));
+
+    const auto sts31 = run_t_design_lazy(31, 3, 2);
+    REQUIRE(sts31);
+    REQUIRE(sts31->size() == 155);
+    REQUIRE(isDesign(31, 2, *sts31));
+}
+
+TEST_CASE("Point-stabilized t-designs") {
+    REQUIRE(isAdmissible(7, 3, 2));
+    REQUIRE(isAdmissible(10, 4, 3));
+    REQUIRE(!isAdmissible(9, 4, 3));
+
+    // For STS(7), {0, 1, 2}, {0, 3, 4}, {0, 5, 6}, and then {1, 3, 5}.
+    constexpr auto fixed = makeStabilizerRows<7, 3, 2, stabilizer::point_and_block>();
+    REQUIRE(fixed.size() == 4);
+    REQUIRE(unrankKSubset<7, 3>(fixed[0] / 3) == std::array<factype, 3>{0, 1, 2});
+    REQUIRE(unrankKSubset<7, 3>(fixed[2] / 3) == std::array<factype, 3>{0, 5, 6});
+    REQUIRE(unrankKSubset<7, 3>(fixed[3] / 3) == std::array<factype, 3>{1, 3, 5});
+
+    // For SQS(10), {0, 1, 2, 3}, ..., {0, 1, 8, 9}, and then {1, 2, 4, 6}.
+    constexpr auto sqsFixed = makeStabilizerRows<10, 4, 3, stabilizer::point_and_block>();
+    REQUIRE(sqsFixed.size() == 5);
+    REQUIRE(unrankKSubset<10, 4>(sqsFixed[4] / 4) == std::array<factype, 4>{1, 2, 4, 6});
+
+    constexpr auto sts7 = run_t_design<7, 3, 2, stabilizer::point_and_block>();
+    REQUIRE(sts7);
+    REQUIRE((*sts7)[rankKSubset<7, 3>({1, 3, 5})]);
+
+    constexpr auto sts15 = run_t_design<15, 3, 2, stabilizer::point>();
+    REQUIRE(sts15);
+    REQUIRE((*sts15)[rankKSubset<15, 3>({0, 13, 14})]);
+
+    constexpr auto sqs10 = run_t_design<10, 4, 3, stabilizer::point_and_block>();
+    REQUIRE(sqs10);
+
+    // This is too much work for the compiler, so solve it at run time.
+    const auto fixed14 = makeStabilizerRows<14, 4, 3, stabilizer::point_and_block>();
+    REQUIRE(std::equal(fixed14.cbegin(), fixed14.cend(),
+                       makeRuntimeStabilizerRows(14, 4, 3, stabilizer::point_and_block).cbegin()));
+    dlx::RuntimeDLX sqs14{nCr(14, 3), nCr(14, 4), makeRuntimeDesignPositions(14, 4, 3)};
+    for (const auto row: fixed14)
+        sqs14.force_row(row);
+    const auto sol = sqs14.run();
+    REQUIRE(sol);
+    REQUIRE(std::count(sol->cbegin(), sol->cend(), true) == 91);
+}
+
+TEST_CASE("Canonical forms of designs") {
+    // The Fano plane, and a relabeling of it.
+    const design fano{{0, 1, 2}, {0, 3, 4}, {0, 5, 6}, {1, 3, 5}, {1, 4, 6}, {2, 3, 6}, {2, 4, 5}};
+    const std::array<factype, 7> sigma{3, 6, 0, 5, 1, 2, 4};
+    design relabeled;
+    for (const auto &block: fano) {
+        std::vector<factype> image;
+        for (const auto p: block)
+            image.emplace_back(sigma[p]);
+        std::sort(image.begin(), image.end());
+        relabeled.emplace_back(image);
+    }
+    REQUIRE(canonicalDesign(7, fano) == canonicalDesign(7, relabeled));
+
+    // Changing one block breaks the isomorphism.
+    auto broken = fano;
+    broken.back() = {2, 4, 6};
+    REQUIRE(canonicalDesign(7, fano) != canonicalDesign(7, broken));
+
+    // The automorphism group of the Fano plane, PSL(2, 7), acts transitively on its 7 points and 7 lines.
+    dlx::coloured_graph g{std::vector<std::vector<dlx::index>>(14), std::vector<size_t>(14)};
+    for (size_t b = 0; b < 7; ++b) {
+        g.colours[7 + b] = 1;
+        for (const auto p: fano[b]) {
+            g.adjacency[p].emplace_back(7 + b);
+            g.adjacency[7 + b].emplace_back(p);
+        }
+    }
+    const auto automorphisms = dlx::canonical_labeling(g).automorphisms;
+    std::vector<bool> reached(14, false);
+    reached[0] = reached[7] = true;
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (const auto &gamma: automorphisms)
+            for (size_t x = 0; x < 14; ++x)
+                if (reached[x] && !reached[gamma[x]])
+                    reached[gamma[x]] = grown = true;
+    }
+    REQUIRE(std::all_of(reached.cbegin(), reached.cend(), [](bool r) { return r; }));
+}
+
+TEST_CASE("Isomorph-free enumeration of t-designs") {
+    REQUIRE(enumerate_t_designs(7, 3, 2, 2).size() == 1);
+    REQUIRE(enumerate_t_designs(8, 3, 2, 2).empty());
+    REQUIRE(enumerate_t_designs(9, 3, 2, 2).size() == 1);
+    REQUIRE(enumerate_t_designs(10, 4, 3, 2).size() == 1);
+
+    const auto sts13 = enumerate_t_designs(13, 3, 2, 2);
+    REQUIRE(sts13.size() == 2);
+    for (const auto &d: sts13)
+        REQUIRE(isDesign(13, 2, d));
+}
+
+TEST_CASE("Isomorph-free enumeration of STS(15)", "[.benchmark]") {
+    REQUIRE(enumerate_t_designs(15, 3, 2).size() == 80);
+}
+
+TEST_CASE("Designs with a prescribed automorphism group") {
+    const auto sts13 = run_t_design_with_group(13, 3, 2, cyclicGroup(13));
+    REQUIRE(sts13);
+    REQUIRE(sts13->size() == 26);
+    REQUIRE(isDesign(13, 2, *sts13));
+
+    // There is no cyclic STS(9).
+    REQUIRE(!run_t_design_with_group(9, 3, 2, cyclicGroup(9)));
+
+    const auto sts61 = run_t_design_with_group(61, 3, 2, cyclicGroup(61));
+    REQUIRE(sts61);
+    REQUIRE(sts61->size() == 610);
+    REQUIRE(isDesign(61, 2, *sts61));
+
+    // An SQS(8) invariant under Z_7 acting on the first 7 points and fixing the last.
+    auto shift = cyclicGroup(7).front();
+    shift.emplace_back(7);
+    const auto sqs8 = run_t_design_with_group(8, 4, 3, {shift});
+    REQUIRE(sqs8);
+    REQUIRE(sqs8->size() == 14);
+    REQUIRE(isDesign(8, 3, *sqs8));
+
+    // The generators must be permutations of the points.
+    REQUIRE_THROWS_AS(run_t_design_with_group(7, 3, 2, {{1, 2, 3, 4, 5, 6, 7}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(run_t_design_with_group(7, 3, 2, {{1, 1, 2, 3, 4, 5, 6}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(run_t_design_with_group(7, 3, 2, {shift}), std::invalid_argument);
+}
+
+TEST_CASE("Verifying t-designs") {
+    constexpr auto sts7 = cmath::run_t_design<7, 3, 2>();
+    static_assert(verify_t_design<7, 3, 2>(*sts7));
+
+    // Dropping a block leaves its pairs uncovered.
+    auto broken = *sts7;
+    *std::find(broken.begin(), broken.end(), true) = false;
+    REQUIRE(!verify_t_design<7, 3, 2>(broken));
+
+    const auto sts61 = run_t_design_with_group(61, 3, 2, cyclicGroup(61));
+    REQUIRE(sts61);
+    REQUIRE(verify_t_design(61, 3, 2, *sts61));
+
+    // Duplicating a block covers its pairs twice.
+    auto tampered = *sts61;
+    tampered.front() = tampered.back();
+    REQUIRE(!verify_t_design(61, 3, 2, tampered));
+
+    // The points of a block must be distinct.
+    design fano{{0, 1, 3}, {1, 2, 4}, {2, 3, 5}, {3, 4, 6}, {0, 4, 5}, {1, 5, 6}, {0, 2, 6}};
+    REQUIRE(verify_t_design(7, 3, 2, fano));
+    fano.front() = {0, 0, 3};
+    REQUIRE(!verify_t_design(7, 3, 2, fano));
+
+    // Solutions from RuntimeDLX check out against the formulation they came from.
+    const auto positions = makeRuntimeDesignPositions(10, 4, 3);
+    dlx::RuntimeDLX solver{nCr(10, 3), nCr(10, 4), positions};
+    const auto sqs10 = solver.run();
+    REQUIRE(sqs10);
+    REQUIRE(dlx::verify_cover(nCr(10, 3), positions, *sqs10));
+    auto extra = *sqs10;
+    *std::find(extra.begin(), extra.end(), false) = true;
+    REQUIRE(!dlx::verify_cover(nCr(10, 3), positions, extra));
+}
+
+TEST_CASE("Counting t-designs with symmetry pruning") {
+    // There are 7! / 168 = 30 labeled Fano planes, and 9! / 432 = 840 labeled STS(9)s.
+    dlx::RuntimeDLX sts7{nCr(7, 2), nCr(7, 3), makeRuntimeDesignPositions(7, 3, 2)};
+    REQUIRE(sts7.count() == 30);
+    REQUIRE(sts7.count_with_symmetry() == 30);
+    REQUIRE(sts7.count_with_symmetry(3) == 30);
+
+    dlx::RuntimeDLX sts9{nCr(9, 2), nCr(9, 3), makeRuntimeDesignPositions(9, 3, 2)};
+    REQUIRE(sts9.count_with_symmetry(2) == 840);
+    REQUIRE(sts9.count() == 840);
+}
+
+TEST_CASE("Designs with a user-supplied symmetry group") {
+    // Let S_7 act on the blocks of STS(7) through its action on the points.
+    const auto induced = [](const permutation &sigma) {
+        dlx::row_permutation rows(nCr(7, 3));
+        for (factype rk = 0; rk < rows.size(); ++rk) {
+            auto block = unrankSubset(7, 3, rk);
+            for (auto &p: block)
+                p = sigma[p];
+            std::sort(block.begin(), block.end());
+            rows[rk] = rankSubset(7, block);
+        }
+        return rows;
+    };
+    const permutation transposition{1, 0, 2, 3, 4, 5, 6};
+
+    dlx::RuntimeDLX sts7{nCr(7, 2), nCr(7, 3), makeRuntimeDesignPositions(7, 3, 2)};
+    sts7.set_row_symmetries({induced(transposition), induced(cyclicGroup(7).front())});
+    REQUIRE(sts7.count() == 30);
+    REQUIRE(sts7.count(10) == 10);
+
+    const auto sol = sts7.run();
+    REQUIRE(sol);
+    design blocks;
+    for (factype rk = 0; rk < sol->size(); ++rk)
+        if ((*sol)[rk])
+            blocks.emplace_back(unrankSubset(7, 3, rk));
+    REQUIRE(isDesign(7, 2, blocks));
+}
+
+TEST_CASE("Parallel enumeration of t-designs") {
+    REQUIRE(count_t_designs(7, 3, 2, stabilizer::none, 4) == 30);
+    REQUIRE(count_t_designs(9, 3, 2, stabilizer::none, 4) == 840);
+    REQUIRE(count_t_designs(10, 4, 3, stabilizer::point, 4) ==
+            dlx::RuntimeDLX{details::designSolver(10, 4, 3, stabilizer::point)}.count());
+    REQUIRE(count_t_designs(8, 3, 2) == 0);
+
+    const auto fano = find_t_designs(7, 3, 2, stabilizer::none, 3);
+    REQUIRE(fano.size() == 30);
+    REQUIRE(std::adjacent_find(fano.cbegin(), fano.cend()) == fano.cend());
+    for (const auto &d: fano) {
+        REQUIRE(isDesign(7, 2, d));
+        REQUIRE(canonicalDesign(7, d) == canonicalDesign(7, fano.front()));
+    }
+}
@@ -8,33 +8,77 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <dlx_contexpr.h>
 
 namespace cmath {
     using factype = unsigned long long;
 
+    /// The largest n for which every binomial coefficient C(n, r) fits in a factype: C(68, 34) > 2^64.
+    constexpr factype maxBinomialN = 67;
+
+    /**
+     * Pascal's triangle up to row n, i.e. table[a][b] = C(a, b) for 0 <= a, b <= n, and 0 if b > a.
+     * @tparam n the last row of the triangle
+     * @return the table
+     */
+    template<factype n>
+    constexpr std::array<std::array<factype, n + 1>, n + 1> makePascalTriangle() noexcept {
+        static_assert(n <= maxBinomialN, "binomial coefficients would overflow factype");
+
+        std::array<std::array<factype, n + 1>, n + 1> table{};
+        table[0][0] = 1;
+        for (factype a = 1; a <= n; ++a) {
+            table[a][0] = 1;
+            for (factype b = 1; b <= a; ++b)
+                table[a][b] = table[a - 1][b - 1] + table[a - 1][b];
+        }
+        return table;
+    }
+
+    /// Pascal's triangle up to row n, computed once per n.
+    template<factype n>
+    inline constexpr auto pascalTriangle = makePascalTriangle<n>();
+
     /**
-     * Binomial coefficient.
+     * Binomial coefficient. This is a table lookup for n <= maxBinomialN, and is computed multiplicatively for
+     * larger n, with C(n, i + 1) = C(n, i) (n - i) / (i + 1). Dividing out the gcd of C(n, i) and i + 1 first keeps
+     * every product a binomial coefficient, so this only overflows if the result does not fit in a factype.
      * @param n
      * @param r
      * @return (n choose r)
+     * @throws std::overflow_error if (n choose r) does not fit in a factype, which in a constant expression is a
+     *         compile time error
      */
-    constexpr factype nCr(factype n, factype r) noexcept {
+    constexpr factype nCr(factype n, factype r) {
         if (n < r)
             return 0;
+        if (n <= maxBinomialN)
+            return pascalTriangle<maxBinomialN>[n][r];
 
-        factype bigger = n - r > r ? n - r : r;
-
+        const factype smaller = n - r < r ? n - r : r;
         factype f = 1;
-        for (factype i = n; i > bigger; --i)
-            f *= i;
-        for (factype i = (n - bigger); i >= 1; --i)
-            f /= i;
+        for (factype i = 0; i < smaller; ++i) {
+            const auto g = std::gcd(f, i + 1);
+            if (__builtin_mul_overflow(f / g, (n - i) / ((i + 1) / g), &f))
+                throw std::overflow_error("binomial coefficient does not fit in factype");
+        }
         return f;
     }
 
@@ -47,14 +91,17 @@ namespace cmath {
      */
     template<factype v, factype k>
     constexpr factype rankKSubset(const std::array<factype, k> &kset) noexcept {
-        factype r = nCr(v, k);
-        for (int i = 0; i < k; ++i)
-            r -= nCr(v - kset[i] - 1, k - i);
+        constexpr const auto &binom = pascalTriangle<v>;
+        factype r = binom[v][k];
+        for (factype i = 0; i < k; ++i)
+            r -= binom[v - kset[i] - 1][k - i];
         return r - 1;
     }
 
     /**
      * Given a valid rank, i.e. 0 <= rk < nCr(v k), find the k-set it counts in lexicographical order.
+     * Each element is found by a binary search down a column of Pascal's triangle, so this takes O(k log v) table
+     * lookups.
      * @tparam v the size of the base set
      * @tparam k the size of the subset
      * @param rank the rank of the k-set
@@ -62,21 +109,33 @@ namespace cmath {
      */
     template<factype v, factype k>
     constexpr std::array<factype, k> unrankKSubset(factype rank) noexcept {
+        constexpr const auto &binom = pascalTriangle<v>;
         std::array<factype, k> kset{};
 
-        factype vi = nCr(v, k);
+        factype vi = binom[v][k];
         factype j = v;
         factype ki = k;
         factype s = rank + 1;
 
         for (factype i = 0; i < k - 1; ++i) {
-            while (s > vi - nCr(j, ki))
-                --j;
+            // Find the largest j' <= j with s <= vi - C(j', ki). This holds for j' = ki - 1, where C(j', ki) = 0, and
+            // C(j', ki) is increasing in j'.
+            if (s > vi - binom[j][ki]) {
+                factype lo = ki - 1;
+                while (j - lo > 1) {
+                    const factype mid = lo + (j - lo) / 2;
+                    if (s > vi - binom[mid][ki])
+                        j = mid;
+                    else
+                        lo = mid;
+                }
+                j = lo;
+            }
             kset[i] = v - j - 1;
 
-            s += nCr(j + 1, ki) - vi;
+            s += binom[j + 1][ki] - vi;
             --ki;
-            vi = nCr(j, ki);
+            vi = binom[j][ki];
         }
 
         kset[k - 1] = v + s - vi - 1;
@@ -106,6 +165,41 @@ namespace cmath {
         return kset;
     }
 
+    /**
+     * Find the rank of a k-subset of [v] in lexicographical order, for v and k given at run time.
+     * @param v the size of the base set
+     * @param kset the k-set to rank, in increasing order
+     * @return the rank of kset
+     */
+    inline factype rankSubset(factype v, const std::vector<factype> &kset) {
+        const factype k = kset.size();
+        factype r = nCr(v, k);
+        for (factype i = 0; i < k; ++i)
+            r -= nCr(v - kset[i] - 1, k - i);
+        return r - 1;
+    }
+
+    /**
+     * Find the k-subset of [v] of a given rank in lexicographical order, for v and k given at run time.
+     * @param v the size of the base set
+     * @param k the size of the subset
+     * @param rank the rank of the k-set
+     * @return the k-set, in increasing order
+     */
+    inline std::vector<factype> unrankSubset(factype v, factype k, factype rank) {
+        std::vector<factype> kset(k);
+        factype x = 0;
+        for (factype i = 0; i < k; ++i) {
+            // There are C(v - x - 1, k - i - 1) k-sets that continue with x.
+            while (rank >= nCr(v - x - 1, k - i - 1)) {
+                rank -= nCr(v - x - 1, k - i - 1);
+                ++x;
+            }
+            kset[i] = x++;
+        }
+        return kset;
+    }
+
     /**
      * Create a formulation of a t-(v, k, 1) design.
      * The columns are the t-sets, of which there are C(v, t).
@@ -115,6 +209,11 @@ namespace cmath {
      * 1. C(v, t) cols
      * 2. C(v, k) rows
      * 3. C(v, k) * C(k, t) entries.
+     *
+     * Rather than unranking every k-set and ranking every t-set, we walk the k-sets in lexicographical order with
+     * succKSubset, which only changes a suffix of the k-set. The rank of the t-set {T_0 < ... < T_{t-1}} is
+     * C(v, t) - 1 - sum_i C(v - T_i - 1, t - i), so we keep the terms of this sum for each position of the
+     * k-set and only recompute those for the positions that changed.
      */
     template<size_t v, size_t k, size_t t,
             size_t cols = nCr(v, t),
@@ -122,21 +221,41 @@ namespace cmath {
             size_t nodes_per_row = nCr(k, t),
             size_t nodes = rows * nodes_per_row>
     constexpr dlx::position_array<nodes> makeDesignPositions() noexcept {
+        constexpr const auto &binom = pascalTriangle<v>;
         dlx::position_array<nodes> array{};
 
+        // The t-subsets of [k], i.e. the positions in a k-set of each of its t-sets, in lexicographical order.
+        std::array<std::array<factype, t>, nodes_per_row> patterns{};
+        for (factype i = 0; i < t; ++i)
+            patterns[0][i] = i;
+        for (factype col = 1; col < nodes_per_row; ++col)
+            patterns[col] = succKSubset<k, t>(patterns[col - 1]);
+
+        // terms[p][i] is the term of the rank sum for the t-set whose ith element is the pth element of the k-set.
+        std::array<std::array<factype, t>, k> terms{};
+        std::array<factype, k> kset{};
+        for (factype i = 0; i < k; ++i)
+            kset[i] = i;
+
         // Keep track of the current node.
         int node = 0;
         for (int row = 0; row < rows; ++row) {
-            const auto kset = unrankKSubset<v, k>(row);
+            // Find the first position that changed, and update the terms from there on.
+            factype changed = 0;
+            if (row > 0) {
+                const auto next = succKSubset<v, k>(kset);
+                while (next[changed] == kset[changed])
+                    ++changed;
+                kset = next;
+            }
+            for (factype p = changed; p < k; ++p)
+                for (factype i = 0; i < t; ++i)
+                    terms[p][i] = binom[v - kset[p] - 1][t - i];
 
             for (int col = 0; col < nodes_per_row; ++col) {
-                const auto tsetIdx = unrankKSubset<k, t>(col);
-
-                // We need to translate tsetIdx into a subset of k-set.
-                std::array<factype, t> tset{};
-                for (int i = 0; i < t; ++i)
-                    tset[i] = kset[tsetIdx[i]];
-                const auto tsetRk = rankKSubset<v, t>(tset);
+                factype tsetRk = binom[v][t] - 1;
+                for (factype i = 0; i < t; ++i)
+                    tsetRk -= terms[patterns[col][i]][i];
 
                 // Now we add a node, namely (row, tsetRk).
                 // In order to mark this methhod constexpr, we need to assign to first and second individually.
@@ -149,21 +268,329 @@ namespace cmath {
         return std::move(array);
     }
 
+    /**
+     * A chunk of the rows of a design formulation in compressed sparse row form: the row firstRow + r, i.e. the
+     * k-set of that rank, contains the t-sets whose ranks are columns[offsets[r]], ..., columns[offsets[r + 1] - 1].
+     */
+    struct design_chunk {
+        factype firstRow;
+        std::vector<size_t> offsets;
+        std::vector<size_t> columns;
+    };
+
+    /**
+     * Generate the formulation of makeDesignPositions at run time, in chunks of at most chunkRows rows, for designs
+     * whose formulation is too large to hold in a position_array (or at all). Each chunk is passed to callback,
+     * and reuses the storage of the previous one, so the callback must copy out anything it wants to keep.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param chunkRows the maximum number of rows in a chunk
+     * @param callback the function to call with each chunk
+     */
+    template<typename Callback>
+    void streamDesignRows(factype v, factype k, factype t, size_t chunkRows, Callback &&callback) {
+        assert(t <= k && k <= v && chunkRows > 0);
+        const auto rows = nCr(v, k);
+        const auto nodesPerRow = nCr(k, t);
+        const auto last = nCr(v, t) - 1;
+
+        // The t-subsets of [k], as in makeDesignPositions, flattened.
+        std::vector<factype> patterns(nodesPerRow * t);
+        std::vector<factype> pattern(t);
+        for (factype i = 0; i < t; ++i)
+            pattern[i] = i;
+        for (factype col = 0; col < nodesPerRow; ++col) {
+            std::copy(pattern.cbegin(), pattern.cend(), patterns.begin() + col * t);
+
+            // Advance to the next t-subset of [k].
+            factype i = t;
+            while (i > 0 && pattern[i - 1] == k - t + i - 1)
+                --i;
+            if (i == 0)
+                break;
+            ++pattern[i - 1];
+            for (factype j = i; j < t; ++j)
+                pattern[j] = pattern[j - 1] + 1;
+        }
+
+        std::vector<factype> terms(k * t);
+        std::vector<factype> kset(k);
+        for (factype i = 0; i < k; ++i)
+            kset[i] = i;
+
+        design_chunk chunk{0, {0}, {}};
+        chunk.offsets.reserve(chunkRows + 1);
+        chunk.columns.reserve(std::min<factype>(chunkRows, rows) * nodesPerRow);
+
+        factype changed = 0;
+        for (factype row = 0; row < rows; ++row) {
+            for (factype p = changed; p < k; ++p)
+                for (factype i = 0; i < t; ++i)
+                    terms[p * t + i] = nCr(v - kset[p] - 1, t - i);
+
+            for (factype col = 0; col < nodesPerRow; ++col) {
+                factype tsetRk = last;
+                for (factype i = 0; i < t; ++i)
+                    tsetRk -= terms[patterns[col * t + i] * t + i];
+                chunk.columns.emplace_back(tsetRk);
+            }
+            chunk.offsets.emplace_back(chunk.columns.size());
+
+            if (chunk.offsets.size() == chunkRows + 1 || row + 1 == rows) {
+                callback(static_cast<const design_chunk&>(chunk));
+                chunk.firstRow = row + 1;
+                chunk.offsets.resize(1);
+                chunk.columns.clear();
+            }
+
+            // Advance to the next k-set, noting the first position that changes.
+            factype i = k;
+            while (i > 0 && kset[i - 1] == v - k + i - 1)
+                --i;
+            if (i == 0)
+                break;
+            ++kset[i - 1];
+            for (factype j = i; j < k; ++j)
+                kset[j] = kset[j - 1] + 1;
+            changed = i - 1;
+        }
+    }
+
+    /**
+     * Narrow a row or column number to the int used by dlx::position.
+     *
+     * @param idx the row or column number
+     * @return idx as an int
+     * @throws std::overflow_error if idx does not fit in an int
+     */
+    inline int toPositionIndex(size_t idx) {
+        if (idx > static_cast<size_t>(std::numeric_limits<int>::max()))
+            throw std::overflow_error("row or column number does not fit in a dlx::position");
+        return static_cast<int>(idx);
+    }
+
+    /**
+     * Collect the formulation of makeDesignPositions at run time, for use with dlx::RuntimeDLX.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @return the positions of the formulation
+     * @throws std::overflow_error if there are more rows or columns than a dlx::position can number
+     */
+    inline dlx::position_vector makeRuntimeDesignPositions(factype v, factype k, factype t) {
+        dlx::position_vector positions;
+        positions.reserve(nCr(v, k) * nCr(k, t));
+        streamDesignRows(v, k, t, 1024, [&positions](const design_chunk &chunk) {
+            for (size_t r = 0; r + 1 < chunk.offsets.size(); ++r)
+                for (auto idx = chunk.offsets[r]; idx < chunk.offsets[r + 1]; ++idx)
+                    positions.emplace_back(toPositionIndex(chunk.firstRow + r), toPositionIndex(chunk.columns[idx]));
+        });
+        return positions;
+    }
+
+    /**
+     * Determine if the parameters of a t-(v, k, 1) design satisfy the divisibility conditions, i.e. C(k - i, t - i)
+     * divides C(v - i, t - i) for 0 <= i < t, which count the blocks through any i points.
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @return true if the conditions hold, and false otherwise
+     */
+    constexpr bool isAdmissible(factype v, factype k, factype t) {
+        if (t > k || k > v)
+            return false;
+        for (factype i = 0; i < t; ++i)
+            if (nCr(v - i, t - i) % nCr(k - i, t - i))
+                return false;
+        return true;
+    }
+
+    /**
+     * Determine if the parameters of a t-(v, k, 1) design satisfy the divisibility conditions.
+     * @tparam v v parameter
+     * @tparam k k parameter
+     * @tparam t t parameter
+     * @return true if the conditions hold, and false otherwise
+     */
+    template<size_t v, size_t k, size_t t>
+    constexpr bool isAdmissible() noexcept {
+        return isAdmissible(v, k, t);
+    }
+
+    /**
+     * The symmetry breaking to apply to a t-design search by forcing blocks that every design has up to relabeling.
+     * 1. none: no blocks are forced.
+     * 2. point: the blocks through the points {0, ..., t - 2} partition the remaining points into groups of size
+     *    k - t + 1, so we force the groups to be consecutive: for STS(v), {0, 1, 2}, {0, 3, 4}, ...
+     * 3. point_and_block: additionally, the block through {1, ..., t - 2} and the first points of the first two
+     *    groups meets k - t + 2 groups in one point each, so we force it to be the first points of the first
+     *    k - t + 2 groups: for STS(v), {1, 3, 5}.
+     */
+    enum class stabilizer {
+        none,
+        point,
+        point_and_block
+    };
+
+    /**
+     * The number of blocks forced by a stabilizer.
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param stab the stabilizer
+     * @return the number of forced blocks
+     */
+    constexpr factype stabilizerBlocks(factype v, factype k, factype t, stabilizer stab) noexcept {
+        if (stab == stabilizer::none || t == 0 || !isAdmissible(v, k, t))
+            return 0;
+
+        const auto groups = (v - t + 1) / (k - t + 1);
+        const auto extra = stab == stabilizer::point_and_block && t >= 2 && groups >= k - t + 2;
+        return groups + (extra ? 1 : 0);
+    }
+
+    /**
+     * A point of a block forced by a stabilizer. The blocks are, in order:
+     * 1. The blocks through {0, ..., t - 2}, i.e. {0, ..., t - 2} and a group of k - t + 1 consecutive points.
+     * 2. For point_and_block, the block through {1, ..., t - 2} and the first points of the first k - t + 2 groups.
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param block the index of the block
+     * @param i the index of the point in the block, in increasing order
+     * @return the point
+     */
+    constexpr factype stabilizerPoint(factype v, factype k, factype t, factype block, factype i) noexcept {
+        const auto groupSize = k - t + 1;
+        const auto groups = (v - t + 1) / groupSize;
+        if (block < groups)
+            return i + 1 < t ? i : t - 1 + block * groupSize + (i - (t - 1));
+        return i + 2 < t ? i + 1 : t - 1 + (i - (t - 2)) * groupSize;
+    }
+
+    /**
+     * The forced blocks of a stabilizer, as fixed rows for DLX, i.e. the index of the first node of each block in
+     * the positions of makeDesignPositions.
+     * @tparam v v parameter
+     * @tparam k k parameter
+     * @tparam t t parameter
+     * @tparam Stab the stabilizer
+     * @return the fixed rows
+     */
+    template<size_t v, size_t k, size_t t, stabilizer Stab,
+            const auto nodes_per_row = nCr(k, t),
+            const auto numFixed = stabilizerBlocks(v, k, t, Stab)>
+    constexpr std::array<size_t, numFixed> makeStabilizerRows() noexcept {
+        std::array<size_t, numFixed> fixed{};
+        for (size_t b = 0; b < numFixed; ++b) {
+            std::array<factype, k> block{};
+            for (size_t i = 0; i < k; ++i)
+                block[i] = stabilizerPoint(v, k, t, b, i);
+            fixed[b] = rankKSubset<v, k>(block) * nodes_per_row;
+        }
+        return fixed;
+    }
+
+    /**
+     * The forced blocks of a stabilizer, as fixed rows for dlx::RuntimeDLX, as in makeStabilizerRows.
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param stab the stabilizer
+     * @return the fixed rows
+     */
+    inline std::vector<size_t> makeRuntimeStabilizerRows(factype v, factype k, factype t, stabilizer stab) {
+        std::vector<size_t> fixed;
+        std::vector<factype> block(k);
+        for (factype b = 0; b < stabilizerBlocks(v, k, t, stab); ++b) {
+            for (factype i = 0; i < k; ++i)
+                block[i] = stabilizerPoint(v, k, t, b, i);
+            fixed.emplace_back(rankSubset(v, block) * nCr(k, t));
+        }
+        return fixed;
+    }
+
     /**
      * A convenience method to run DLX for a t-design and return the solution.
+     *
+     * Designs whose parameters fail the divisibility conditions are rejected immediately. Otherwise, the blocks of
+     * the stabilizer are forced into the solution, which removes most of the v! relabelings of each design from
+     * the search without losing any design up to isomorphism.
+     *
      * @tparam v v parameter
      * @tparam k k parameter
      * @tparam t t parameter
+     * @tparam Stab the symmetry breaking to apply
      * @return the solution as an optional
      */
     template<size_t v, size_t k, size_t t,
+            stabilizer Stab = stabilizer::none,
             const auto cols = nCr(v, t),
             const auto rows = nCr(v, k),
             const auto nodes_per_row = nCr(k, t),
             const auto nodes = rows * nodes_per_row>
     constexpr std::optional<std::array<bool, rows>> run_t_design() noexcept {
         // Solve, all constexpr!
-        return dlx::DLX<cols, rows, nodes>::run(makeDesignPositions<v, k, t>());
+        using DLX = dlx::DLX<cols, rows, nodes>;
+        if constexpr (!isAdmissible<v, k, t>())
+            return std::nullopt;
+        else if constexpr (Stab == stabilizer::none)
+            return DLX::run(makeDesignPositions<v, k, t>());
+        else
+            return DLX::run(makeDesignPositions<v, k, t>(), makeStabilizerRows<v, k, t, Stab>());
+    }
+
+    /**
+     * Verify that a solution of run_t_design is a t-(v, k, 1) design, i.e. that every t-set is in exactly one of
+     * its blocks, with a bitmap of the t-sets covered, without building the formulation.
+     *
+     * @tparam v v parameter
+     * @tparam k k parameter
+     * @tparam t t parameter
+     * @param solution the solution
+     * @return true if the solution is a design, and false otherwise
+     */
+    template<size_t v, size_t k, size_t t,
+            const auto cols = nCr(v, t),
+            const auto rows = nCr(v, k),
+            const auto nodes_per_row = nCr(k, t)>
+    constexpr bool verify_t_design(const std::array<bool, rows> &solution) noexcept {
+        std::array<factype, t> pattern{};
+        for (factype i = 0; i < t; ++i)
+            pattern[i] = i;
+        std::array<std::array<factype, t>, nodes_per_row> patterns{};
+        for (factype col = 0; col < nodes_per_row; ++col) {
+            patterns[col] = pattern;
+            if (col + 1 < nodes_per_row)
+                pattern = succKSubset<k, t>(pattern);
+        }
+
+        std::array<std::uint64_t, (cols + dlx::details::WordBits - 1) / dlx::details::WordBits> covered{};
+        for (factype row = 0; row < rows; ++row) {
+            if (!solution[row]) continue;
+
+            const auto kset = unrankKSubset<v, k>(row);
+            for (const auto &p: patterns) {
+                std::array<factype, t> tset{};
+                for (factype i = 0; i < t; ++i)
+                    tset[i] = kset[p[i]];
+                const auto rk = rankKSubset<v, t>(tset);
+
+                const std::uint64_t bit = std::uint64_t{1} << (rk % dlx::details::WordBits);
+                auto &word = covered[rk / dlx::details::WordBits];
+                if (word & bit)
+                    return false;
+                word |= bit;
+            }
+        }
+
+        size_t count = 0;
+        for (const auto word: covered)
+            count += __builtin_popcountll(word);
+        return count == cols;
     }
 
     /**
@@ -187,4 +614,479 @@ namespace cmath {
             }
         std::flush(std::clog);
     }
+
+    /**
+     * The oracle for LazyDLX that supplies the blocks of a t-(v, k, 1) design on demand: the rows covering the
+     * column of a t-set are the k-sets that contain it and none of the covered t-sets. The k-sets are built one
+     * point at a time, and abandoned as soon as a point completes a covered t-set.
+     */
+    class design_oracle {
+    public:
+        design_oracle(factype v, factype k, factype t) noexcept: v{v}, k{k}, t{t} {}
+
+        void operator()(dlx::index column, const std::vector<bool> &covered, std::vector<dlx::lazy_row> &rows) const {
+            std::vector<factype> block = unrankSubset(v, t, column);
+            dlx::lazy_row row{column};
+            extend(covered, block, row, 0, rows);
+        }
+
+    private:
+        factype v;
+        factype k;
+        factype t;
+
+        /**
+         * Extend a partial block by points of at least from that are not already in it.
+         *
+         * @param covered the covered t-sets
+         * @param block the points of the partial block
+         * @param row the ranks of the t-sets of the partial block
+         * @param from the smallest point to add
+         * @param rows the complete blocks, as rows
+         */
+        void extend(const std::vector<bool> &covered, std::vector<factype> &block, dlx::lazy_row &row,
+                    factype from, std::vector<dlx::lazy_row> &rows) const {
+            if (block.size() == k) {
+                rows.emplace_back(row);
+                return;
+            }
+
+            for (factype p = from; p + (k - block.size()) <= v; ++p) {
+                if (std::find(block.cbegin(), block.cend(), p) != block.cend())
+                    continue;
+
+                // Add the t-sets formed by p and t - 1 points of the block, unless one is covered.
+                const auto size = row.size();
+                const auto points = block.size();
+                std::vector<factype> choice(t - 1);
+                for (factype i = 0; i + 1 < t; ++i)
+                    choice[i] = i;
+
+                bool live = true;
+                while (live) {
+                    std::vector<factype> tset{p};
+                    for (const auto i: choice)
+                        tset.emplace_back(block[i]);
+                    std::sort(tset.begin(), tset.end());
+                    const auto rk = rankSubset(v, tset);
+                    if (covered[rk])
+                        live = false;
+                    else
+                        row.emplace_back(rk);
+
+                    // Advance to the next (t - 1)-subset of the block.
+                    factype i = t - 1;
+                    while (i > 0 && choice[i - 1] == points - t + i)
+                        --i;
+                    if (i == 0)
+                        break;
+                    ++choice[i - 1];
+                    for (factype j = i; j + 1 < t; ++j)
+                        choice[j] = choice[j - 1] + 1;
+                }
+
+                if (live) {
+                    block.emplace_back(p);
+                    extend(covered, block, row, p + 1, rows);
+                    block.pop_back();
+                }
+                row.resize(size);
+            }
+        }
+    };
+
+    /**
+     * Find a t-(v, k, 1) design without materializing the C(v, k) rows of its formulation, using LazyDLX with
+     * design_oracle, for designs beyond the reach of makeDesignPositions.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @return the blocks of the design, each in increasing order, if one exists
+     */
+    inline std::optional<std::vector<std::vector<factype>>> run_t_design_lazy(factype v, factype k, factype t) {
+        dlx::LazyDLX<design_oracle> search{nCr(v, t), nCr(v, t), design_oracle{v, k, t}};
+        const auto sol = search.run();
+        if (!sol.has_value())
+            return std::nullopt;
+
+        // Recover the points of each block from its t-sets.
+        std::vector<std::vector<factype>> blocks;
+        for (const auto &row: *sol) {
+            std::vector<factype> block;
+            for (const auto rk: row)
+                for (const auto e: unrankSubset(v, t, rk))
+                    if (std::find(block.cbegin(), block.cend(), e) == block.cend())
+                        block.emplace_back(e);
+            std::sort(block.begin(), block.end());
+            blocks.emplace_back(std::move(block));
+        }
+        return blocks;
+    }
+
+    /// The blocks of a design, each in increasing order.
+    using design = std::vector<std::vector<factype>>;
+
+    /**
+     * Find the canonical form of a (partial) design on the points [v]: relabel it by the canonical labeling of its
+     * point-block incidence graph and sort the blocks. Two designs are isomorphic if and only if they have the
+     * same canonical form.
+     *
+     * @param v the number of points
+     * @param blocks the blocks of the design
+     * @return the canonical form
+     */
+    inline design canonicalDesign(factype v, const design &blocks) {
+        dlx::coloured_graph g{std::vector<std::vector<dlx::index>>(v + blocks.size()), std::vector<size_t>(v, 0)};
+        g.colours.resize(v + blocks.size(), 1);
+        for (size_t b = 0; b < blocks.size(); ++b)
+            for (const auto p: blocks[b]) {
+                g.adjacency[p].emplace_back(v + b);
+                g.adjacency[v + b].emplace_back(p);
+            }
+
+        // The points have the smaller colour, so they receive the labels [v].
+        const auto labels = dlx::canonical_labeling(g).labels;
+        design result;
+        for (const auto &block: blocks) {
+            std::vector<factype> image;
+            for (const auto p: block)
+                image.emplace_back(labels[p]);
+            std::sort(image.begin(), image.end());
+            result.emplace_back(std::move(image));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     * Enumerate the t-(v, k, 1) designs up to isomorphism.
+     *
+     * The blocks of the point_and_block stabilizer are forced, and the search then proceeds breadth first, one
+     * block per level, as DLX would branch. At every level, the partial designs are reduced to one per
+     * isomorphism class by the canonical form of their point-block incidence graphs: isomorphic partial designs
+     * have isomorphic completions, so those of the representative stand for those of the whole class. No
+     * relabeled copy of a partial design is ever extended, and the last level holds one design per class. The
+     * children of each level are generated and put into canonical form in parallel.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param threads the number of threads to use
+     * @return the canonical forms of the designs, one per isomorphism class, in increasing order
+     */
+    inline std::vector<design> enumerate_t_designs(factype v, factype k, factype t,
+                                                   size_t threads = std::thread::hardware_concurrency()) {
+        if (!isAdmissible(v, k, t))
+            return {};
+
+        dlx::RuntimeDLX base{nCr(v, t), nCr(v, k), makeRuntimeDesignPositions(v, k, t)};
+        const auto fixed = makeRuntimeStabilizerRows(v, k, t, stabilizer::point_and_block);
+        for (const auto row: fixed)
+            base.force_row(row);
+
+        // A partial design is given by the nodes forced beyond the stabilizer.
+        const auto partialOf = [&](const std::vector<dlx::index> &nodes) {
+            design blocks;
+            for (const auto node: fixed)
+                blocks.emplace_back(unrankSubset(v, k, base.row_of(node)));
+            for (const auto node: nodes)
+                blocks.emplace_back(unrankSubset(v, k, base.row_of(node)));
+            return blocks;
+        };
+
+        // The representatives of the classes of partial designs at the current level, by canonical form.
+        using level = std::map<design, std::vector<dlx::index>>;
+        level current{{canonicalDesign(v, partialOf({})), {}}};
+        std::vector<design> designs;
+        while (!current.empty()) {
+            std::vector<const level::value_type*> tasks;
+            for (const auto &entry: current)
+                tasks.emplace_back(&entry);
+
+            // Extend every representative by the rows of the column DLX would branch on.
+            std::vector<level> children(tasks.size());
+            std::vector<char> complete(tasks.size(), false);
+            dlx::parallel_for(tasks.size(), threads, [&](size_t i) {
+                const auto &[form, nodes] = *tasks[i];
+                auto solver = base;
+                for (const auto node: nodes)
+                    solver.force_row(node);
+                complete[i] = solver.complete();
+
+                for (const auto node: solver.branch_rows()) {
+                    auto child = nodes;
+                    child.emplace_back(node);
+                    children[i].emplace(canonicalDesign(v, partialOf(child)), std::move(child));
+                }
+            });
+
+            level next;
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                if (complete[i])
+                    designs.emplace_back(tasks[i]->first);
+                next.merge(children[i]);
+            }
+            current = std::move(next);
+        }
+        std::sort(designs.begin(), designs.end());
+        return designs;
+    }
+
+    /**
+     * Verify that a set of blocks is a t-(v, k, 1) design, as the template version of verify_t_design does.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param blocks the blocks, each in strictly increasing order
+     * @return true if the blocks form a design, and false otherwise
+     */
+    inline bool verify_t_design(factype v, factype k, factype t, const design &blocks) {
+        const auto cols = nCr(v, t);
+        std::vector<std::uint64_t> covered((cols + dlx::details::WordBits - 1) / dlx::details::WordBits);
+        std::vector<factype> tset(t);
+        for (const auto &block: blocks) {
+            if (block.size() != k || (k > 0 && block.back() >= v)
+                || std::adjacent_find(block.cbegin(), block.cend(), std::greater_equal<>{}) != block.cend())
+                return false;
+
+            // Visit the t-subsets of the block.
+            std::vector<factype> pattern(t);
+            for (factype i = 0; i < t; ++i)
+                pattern[i] = i;
+            while (true) {
+                for (factype i = 0; i < t; ++i)
+                    tset[i] = block[pattern[i]];
+                const auto rk = rankSubset(v, tset);
+
+                const std::uint64_t bit = std::uint64_t{1} << (rk % dlx::details::WordBits);
+                auto &word = covered[rk / dlx::details::WordBits];
+                if (word & bit)
+                    return false;
+                word |= bit;
+
+                factype i = t;
+                while (i > 0 && pattern[i - 1] == k - t + i - 1)
+                    --i;
+                if (i == 0)
+                    break;
+                ++pattern[i - 1];
+                for (factype j = i; j < t; ++j)
+                    pattern[j] = pattern[j - 1] + 1;
+            }
+        }
+
+        size_t count = 0;
+        for (const auto word: covered)
+            count += __builtin_popcountll(word);
+        return count == cols;
+    }
+
+    namespace details {
+        /**
+         * The formulation of a t-(v, k, 1) design for RuntimeDLX, with the blocks of a stabilizer forced.
+         */
+        inline dlx::RuntimeDLX designSolver(factype v, factype k, factype t, stabilizer stab) {
+            dlx::RuntimeDLX solver{nCr(v, t), nCr(v, k), makeRuntimeDesignPositions(v, k, t)};
+            for (const auto row: makeRuntimeStabilizerRows(v, k, t, stab))
+                solver.force_row(row);
+            return solver;
+        }
+    }
+
+    /**
+     * Count the t-(v, k, 1) designs on the points [v] containing the blocks of a stabilizer, i.e. all labeled
+     * designs for stabilizer::none. The search is split into subproblems by the choices of the blocks covering the
+     * first t-sets it branches on, which are counted in parallel, each on its own copy of the formulation.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param stab the stabilizer
+     * @param threads the number of threads to use
+     * @return the number of designs
+     */
+    inline size_t count_t_designs(factype v, factype k, factype t, stabilizer stab = stabilizer::none,
+                                  size_t threads = std::thread::hardware_concurrency()) {
+        if (!isAdmissible(v, k, t))
+            return 0;
+        return dlx::parallel_count(details::designSolver(v, k, t, stab), threads);
+    }
+
+    /**
+     * Find the t-(v, k, 1) designs on the points [v] containing the blocks of a stabilizer in parallel, as in
+     * count_t_designs.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param stab the stabilizer
+     * @param threads the number of threads to use
+     * @return the designs, in increasing order
+     */
+    inline std::vector<design> find_t_designs(factype v, factype k, factype t, stabilizer stab = stabilizer::none,
+                                              size_t threads = std::thread::hardware_concurrency()) {
+        if (!isAdmissible(v, k, t))
+            return {};
+
+        std::mutex mutex;
+        std::vector<design> designs;
+        dlx::parallel_for_each_solution(details::designSolver(v, k, t, stab), threads,
+                                        [&](const dlx::RuntimeDLX::solution &sol) {
+            design blocks;
+            for (factype row = 0; row < sol.size(); ++row)
+                if (sol[row])
+                    blocks.emplace_back(unrankSubset(v, k, row));
+
+            const std::lock_guard<std::mutex> lock{mutex};
+            designs.emplace_back(std::move(blocks));
+        });
+        std::sort(designs.begin(), designs.end());
+        return designs;
+    }
+
+    /// A permutation of the points [v], mapping p to permutation[p].
+    using permutation = std::vector<factype>;
+
+    /**
+     * The generator of the cyclic group Z_v acting on the points [v], i.e. p -> p + 1 mod v.
+     * @param v the number of points
+     * @return the generator
+     */
+    inline std::vector<permutation> cyclicGroup(factype v) {
+        permutation shift(v);
+        for (factype p = 0; p < v; ++p)
+            shift[p] = (p + 1) % v;
+        return {shift};
+    }
+
+    /**
+     * The orbits of the k-subsets of [v] under the group generated by a set of permutations.
+     */
+    struct subset_orbits {
+        // The orbit of each k-set, indexed by its rank.
+        std::vector<size_t> orbitOf;
+
+        // The ranks of the k-sets in each orbit, starting with the smallest, which represents the orbit.
+        std::vector<std::vector<factype>> members;
+    };
+
+    /**
+     * Find the orbits of the k-subsets of [v] under the group generated by a set of permutations.
+     * @param v the number of points
+     * @param k the size of the subsets
+     * @param generators the generators of the group, each of which must be a permutation of [v]
+     * @return the orbits
+     */
+    inline subset_orbits findOrbits(factype v, factype k, const std::vector<permutation> &generators) {
+        const auto total = nCr(v, k);
+        const auto unassigned = std::numeric_limits<size_t>::max();
+        subset_orbits orbits{std::vector<size_t>(total, unassigned), {}};
+
+        std::vector<factype> image(k);
+        for (factype rank = 0; rank < total; ++rank) {
+            if (orbits.orbitOf[rank] != unassigned) continue;
+
+            // Close the orbit of the k-set under the generators.
+            const auto orbit = orbits.members.size();
+            orbits.orbitOf[rank] = orbit;
+            orbits.members.push_back({rank});
+            for (size_t i = 0; i < orbits.members[orbit].size(); ++i) {
+                const auto kset = unrankSubset(v, k, orbits.members[orbit][i]);
+                for (const auto &gen: generators) {
+                    for (factype j = 0; j < k; ++j)
+                        image[j] = gen[kset[j]];
+                    std::sort(image.begin(), image.end());
+                    const auto rk = rankSubset(v, image);
+                    if (orbits.orbitOf[rk] == unassigned) {
+                        orbits.orbitOf[rk] = orbit;
+                        orbits.members[orbit].emplace_back(rk);
+                    }
+                }
+            }
+        }
+        return orbits;
+    }
+
+    /**
+     * Find a t-(v, k, 1) design with a prescribed automorphism group by the method of Kramer and Mesner.
+     *
+     * The group partitions the t-sets and the k-sets into orbits, and a design invariant under the group is a
+     * union of k-set orbits. The orbit matrix has an entry for each t-set orbit T and k-set orbit K, namely the
+     * number of k-sets in K that contain a fixed t-set of T. A k-set orbit with an entry above 1 covers some t-set
+     * twice and can never be used, so the design is an exact cover of the t-set orbits by the remaining k-set
+     * orbits, which is a far smaller problem than that of makeDesignPositions.
+     *
+     * @param v v parameter
+     * @param k k parameter
+     * @param t t parameter
+     * @param generators the generators of the automorphism group, e.g. cyclicGroup(v)
+     * @return the blocks of a design invariant under the group, if one exists
+     * @throws std::invalid_argument if a generator is not a permutation of [v]
+     */
+    inline std::optional<design> run_t_design_with_group(factype v, factype k, factype t,
+                                                         const std::vector<permutation> &generators) {
+        // A permutation of [v] is one whose images, sorted, are 0, ..., v - 1.
+        std::vector<factype> points(v);
+        std::iota(points.begin(), points.end(), 0);
+        for (auto images: generators) {
+            std::sort(images.begin(), images.end());
+            if (images != points)
+                throw std::invalid_argument("a generator is not a permutation of the points");
+        }
+
+        if (!isAdmissible(v, k, t))
+            return std::nullopt;
+
+        const auto tOrbits = findOrbits(v, t, generators);
+        const auto kOrbits = findOrbits(v, k, generators);
+
+        // Build the orbit matrix a row at a time, keeping the k-set orbits whose entries are all 0 or 1.
+        dlx::position_vector positions;
+        std::vector<size_t> usable;
+        std::vector<size_t> hits(tOrbits.members.size());
+        std::vector<size_t> touched;
+        std::vector<factype> tset(t);
+        for (size_t orbit = 0; orbit < kOrbits.members.size(); ++orbit) {
+            touched.clear();
+            for (const auto rk: kOrbits.members[orbit]) {
+                const auto kset = unrankSubset(v, k, rk);
+                for (factype trk = 0; trk < nCr(k, t); ++trk) {
+                    const auto pattern = unrankSubset(k, t, trk);
+                    for (factype i = 0; i < t; ++i)
+                        tset[i] = kset[pattern[i]];
+                    const auto tOrbit = tOrbits.orbitOf[rankSubset(v, tset)];
+                    if (hits[tOrbit]++ == 0)
+                        touched.emplace_back(tOrbit);
+                }
+            }
+
+            // The entry for a t-set orbit is the number of incidences divided by the size of the t-set orbit.
+            std::sort(touched.begin(), touched.end());
+            const bool simple = std::all_of(touched.cbegin(), touched.cend(), [&](size_t tOrbit) {
+                return hits[tOrbit] == tOrbits.members[tOrbit].size();
+            });
+            if (simple) {
+                for (const auto tOrbit: touched)
+                    positions.emplace_back(toPositionIndex(usable.size()), toPositionIndex(tOrbit));
+                usable.emplace_back(orbit);
+            }
+            for (const auto tOrbit: touched)
+                hits[tOrbit] = 0;
+        }
+
+        const auto sol = dlx::RuntimeDLX{tOrbits.members.size(), usable.size(), positions}.run();
+        if (!sol.has_value())
+            return std::nullopt;
+
+        // Expand the chosen orbits back into blocks.
+        design blocks;
+        for (size_t row = 0; row < usable.size(); ++row)
+            if ((*sol)[row])
+                for (const auto rk: kOrbits.members[usable[row]])
+                    blocks.emplace_back(unrankSubset(v, k, rk));
+        std::sort(blocks.begin(), blocks.end());
+        return blocks;
+    }
 }
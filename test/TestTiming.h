@@ -0,0 +1,26 @@
+/**
+ * TestTiming.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+namespace timing {
+    /**
+     * Time a call, for the benchmarks.
+     *
+     * @param f the call, which must return a value
+     * @return the result of the call and the time it took in seconds
+     */
+    template<typename F>
+    auto timed(F &&f) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = f();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::pair{std::move(result), elapsed.count()};
+    }
+}
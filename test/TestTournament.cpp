@@ -0,0 +1,100 @@
+/**
+ * TestTournament.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include <catch.hpp>
+#include <dlx_contexpr.h>
+
+#include "TestTournament.h"
+#include "TestTiming.h"
+
+using namespace tournament;
+
+namespace {
+    /// Determine if a schedule is a round robin of n teams in which no two teams sharing a venue are both home.
+    bool isSchedule(size_t n, const schedule &s, const std::vector<venue> &venues = {}) {
+        if (s.size() != n - 1)
+            return false;
+
+        std::vector<std::vector<bool>> met(n, std::vector<bool>(n, false));
+        for (const auto &round: s) {
+            std::vector<bool> played(n, false);
+            std::vector<bool> home(n, false);
+            for (const auto &[a, b]: round) {
+                if (a == b || played[a] || played[b] || met[a][b])
+                    return false;
+                played[a] = played[b] = true;
+                met[a][b] = met[b][a] = true;
+                home[a] = true;
+            }
+            if (std::find(played.cbegin(), played.cend(), false) != played.cend())
+                return false;
+            for (const auto &[t, u]: venues)
+                if (home[t] && home[u])
+                    return false;
+        }
+        return true;
+    }
+
+    /// Pair up teams 2i and 2i + 1 as sharing a venue, for i < pairs.
+    std::vector<venue> sharedVenues(size_t pairs) {
+        std::vector<venue> venues;
+        for (size_t i = 0; i < pairs; ++i)
+            venues.emplace_back(2 * i, 2 * i + 1);
+        return venues;
+    }
+}
+
+TEST_CASE("Round robin tournaments") {
+    const auto s = run_tournament(8);
+    REQUIRE(s);
+    print_schedule(*s);
+    REQUIRE(isSchedule(8, *s));
+
+    // The numbers of one-factorizations of K_4, K_6 and K_8.
+    REQUIRE(count_tournaments(2) == 1);
+    REQUIRE(count_tournaments(4) == 1);
+    REQUIRE(count_tournaments(6) == 6);
+    REQUIRE(count_tournaments(8) == 6240);
+
+    // Without fixing the rounds, every one-factorization is counted once per ordering of its rounds.
+    REQUIRE(count_tournaments(6, standard, {}, false) == 6 * 120);
+
+    // There are no rounds for fewer than two teams, and an odd number of teams cannot all play in every round.
+    REQUIRE_THROWS_AS(count_tournaments(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(run_tournament(5), std::invalid_argument);
+}
+
+TEST_CASE("Round robin tournaments with shared venues") {
+    // Each of the 6 games can be played at either home.
+    REQUIRE(count_tournaments(4, home_away) == 64);
+
+    // If teams 0 and 1 share a ground, they cannot both be home in the rounds in which they do not meet.
+    REQUIRE(count_tournaments(4, home_away, sharedVenues(1)) == 4 * 3 * 3);
+
+    const auto venues = sharedVenues(5);
+    const auto s = run_tournament(10, home_away, venues);
+    REQUIRE(s);
+    print_schedule(*s);
+    REQUIRE(isSchedule(10, *s, venues));
+}
+
+TEST_CASE("Schedule and count round robin tournaments", "[.benchmark]") {
+    for (const size_t n: {10, 20, 30, 40}) {
+        const auto venues = sharedVenues(n / 2);
+        const auto [s, elapsed] = timing::timed([&] { return run_tournament(n, home_away, venues); });
+        std::clog << n << " teams: scheduled in " << elapsed << "s" << std::endl;
+        REQUIRE(s);
+        REQUIRE(isSchedule(n, *s, venues));
+    }
+
+    const auto [count, elapsed] = timing::timed([] { return count_tournaments(8, standard, {}, false); });
+    std::clog << "8 teams: " << count << " schedules in " << elapsed << "s" << std::endl;
+    REQUIRE(count == 6240 * 5040);
+}
@@ -0,0 +1,161 @@
+/**
+ * TestTournament.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <dlx_contexpr.h>
+
+namespace tournament {
+    /// Opt-in constraints on the schedules, which may be combined with |.
+    enum constraint : unsigned {
+        /// A round robin: every pair of teams meets once, and every team plays once per round.
+        standard = 0,
+
+        /// Every game is played at the home of one of its teams.
+        home_away = 1u << 0u
+    };
+
+    /// Teams sharing a ground, which can host at most one game per round.
+    using venue = std::pair<size_t, size_t>;
+
+    /// A game in a round: the home and away teams, or the two teams in increasing order without home_away.
+    using game = std::pair<size_t, size_t>;
+
+    /// A schedule: the games of each round.
+    using schedule = std::vector<std::vector<game>>;
+
+    /**
+     * The formulation of the round robin tournaments of n teams, i.e. the one-factorizations of K_n, in n - 1
+     * rounds. The columns consist of:
+     * 1. n (n - 1) primary entries T_rt, which represent that team t plays in round r.
+     * 2. C(n, 2) primary entries P_ab, which represent that teams a < b meet.
+     * 3. For each shared venue v, n - 1 secondary entries V_vr, which represent that a game is played at v in
+     *    round r.
+     * The rows are the games in each round, with the home team first if home matters, in the order of games.
+     */
+    struct formulation {
+        size_t columns;
+        size_t primaryColumns;
+        std::vector<std::pair<size_t, game>> games;
+        dlx::position_vector positions;
+    };
+
+    /**
+     * Create the formulation of the round robin tournaments of n teams.
+     *
+     * The rounds of a tournament may be permuted freely, so if fixRounds is set, team 0 meets team r + 1 in round
+     * r. Every one-factorization then has exactly one schedule, and the (n - 1)! relabelings of the rounds are
+     * never searched.
+     *
+     * @param n the number of teams, which must be even
+     * @param constraints the constraints, combined with |
+     * @param venues the pairs of teams sharing a ground, which imply home_away if there are any
+     * @param fixRounds true if the rounds are to be labeled by the opponents of team 0
+     * @return the formulation
+     * @throws std::invalid_argument if n is odd or less than 2, for which there are no rounds
+     */
+    inline formulation makeTournament(size_t n, unsigned constraints = standard,
+                                      const std::vector<venue> &venues = {}, bool fixRounds = true) {
+        if (n < 2 || n % 2 != 0)
+            throw std::invalid_argument("a round robin tournament needs an even number of teams, at least 2");
+        if (!venues.empty())
+            constraints |= home_away;
+
+        const auto rounds = n - 1;
+        const auto pairColumn = [n, rounds](size_t a, size_t b) {
+            // The pairs (a, b) with a < b, in lexicographic order.
+            return n * rounds + a * n - a * (a + 1) / 2 + (b - a - 1);
+        };
+        const auto primary = n * rounds + n * rounds / 2;
+
+        formulation f{primary + venues.size() * rounds, primary, {}, {}};
+        for (size_t r = 0; r < rounds; ++r)
+            for (size_t a = 0; a < n; ++a)
+                for (size_t b = a + 1; b < n; ++b) {
+                    if (fixRounds && a == 0 && b != r + 1)
+                        continue;
+
+                    const auto addGame = [&](size_t home, size_t away) {
+                        const auto row = static_cast<int>(f.games.size());
+                        f.positions.emplace_back(row, static_cast<int>(r * n + a));
+                        f.positions.emplace_back(row, static_cast<int>(r * n + b));
+                        f.positions.emplace_back(row, static_cast<int>(pairColumn(a, b)));
+                        for (size_t v = 0; v < venues.size(); ++v)
+                            if (venues[v].first == home || venues[v].second == home)
+                                f.positions.emplace_back(row, static_cast<int>(primary + v * rounds + r));
+                        f.games.emplace_back(r, game{home, away});
+                    };
+
+                    addGame(a, b);
+                    if (constraints & home_away)
+                        addGame(b, a);
+                }
+        return f;
+    }
+
+    /**
+     * Find a round robin tournament of n teams.
+     *
+     * @param n the number of teams, which must be even
+     * @param constraints the constraints, combined with |
+     * @param venues the pairs of teams sharing a ground
+     * @return a schedule if one exists, and nullopt otherwise
+     * @throws std::invalid_argument if n is odd or less than 2
+     */
+    inline std::optional<schedule> run_tournament(size_t n, unsigned constraints = standard,
+                                                  const std::vector<venue> &venues = {}) {
+        const auto f = makeTournament(n, constraints, venues);
+        dlx::RuntimeDLX solver{f.columns, f.games.size(), f.positions, f.primaryColumns};
+        const auto sol = solver.run();
+        if (!sol)
+            return std::nullopt;
+
+        schedule s(n - 1);
+        for (size_t row = 0; row < sol->size(); ++row)
+            if ((*sol)[row])
+                s[f.games[row].first].emplace_back(f.games[row].second);
+        return s;
+    }
+
+    /**
+     * Count the round robin tournaments of n teams. The search is split into subproblems, which are counted in
+     * parallel.
+     *
+     * @param n the number of teams, which must be even
+     * @param constraints the constraints, combined with |
+     * @param venues the pairs of teams sharing a ground
+     * @param fixRounds true if the rounds are to be labeled by the opponents of team 0, in which case the
+     *                  count without home_away is the number of one-factorizations of K_n
+     * @param threads the number of threads to use
+     * @return the number of schedules
+     * @throws std::invalid_argument if n is odd or less than 2
+     */
+    inline size_t count_tournaments(size_t n, unsigned constraints = standard, const std::vector<venue> &venues = {},
+                                    bool fixRounds = true, size_t threads = std::thread::hardware_concurrency()) {
+        const auto f = makeTournament(n, constraints, venues, fixRounds);
+        return dlx::parallel_count(dlx::RuntimeDLX{f.columns, f.games.size(), f.positions, f.primaryColumns},
+                                   threads);
+    }
+
+    /// Display a schedule to clog.
+    inline void print_schedule(const schedule &s) noexcept {
+        for (size_t r = 0; r < s.size(); ++r) {
+            std::clog << "Round " << r + 1 << ':';
+            for (const auto &[a, b]: s[r])
+                std::clog << ' ' << a << '-' << b;
+            std::clog << '\n';
+        }
+        std::flush(std::clog);
+    }
+}